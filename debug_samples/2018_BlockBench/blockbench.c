@@ -15,7 +15,35 @@
  direct = disable skip OS read buferring
  wsync = disable OS writeback caching
  precision = time or precision priority, values: fast, slow
- machinereadable = make output machine readable (hex data), values: 0 or 1
+             slow = each line read repeatedly until width of median 95%
+             confidence interval (bootstrap) not above ci percents of median,
+             warm-up passes detected by MSER rule and discarded,
+             from minpasses to maxpasses passes, budget seconds per line
+ ci = slow precision target, median confidence interval width, percents
+ minpasses = slow precision minimum passes per line, after warm-up
+ maxpasses = slow precision maximum passes per line
+ budget = slow precision wall clock limit per line, seconds, 0 = not limited
+ duration = soak mode, start..stop zone read again until duration expired,
+            seconds, 0 = not used, constant memory streaming statistics:
+            Welford mean and variance, P-square P5, median, P95, drift =
+            sustained change of sweep MBPS by two-sided CUSUM, same as mapfile,
+            one sample per full start..stop sweep, zones speed differences
+            (outer and inner HDD tracks) not reported as drift
+ interval = soak mode periodic summary interval, seconds, default 60
+ device statistics from /sys/dev/block/<major:minor>/stat printed after run:
+         IOs, bytes, average request size, queue time, wait per IO,
+         amplification = device bytes / bytes moved by benchmark
+ timer = time source for speed measurement, values: auto, tsc, monotonic
+         tsc = invariant TSC calibrated against CLOCK_MONOTONIC_RAW (x86 only),
+         auto = tsc if invariant TSC reported by CPUID, otherwise monotonic,
+         read overhead measured at start and subtracted from intervals
+ output = results format at stdout, values: text, json, csv
+          json and csv = start conditions, per line samples, statistics,
+          device statistics and resource usage as records of one schema:
+          section, scenario, benchmark, operation, pass, name, value,
+          console text moved to stderr
+ machinereadable = make output machine readable, values: 0 or 1,
+                   1 means output=csv if output not set
 
  BUGS AND NOTES.
  - all delta time visual, for all 4 timers
@@ -39,6 +67,7 @@
 #include <string.h>
 #include <errno.h>
 #include <time.h>
+#include <math.h>
 #include <ctype.h>
 #include <unistd.h>
 #include <sys/time.h>
@@ -47,8 +76,14 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/sysmacros.h>
 #include <linux/hdreg.h>
 #include <linux/fs.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#include <cpuid.h>
+#define TIMER_X86           // TSC time source supported
+#endif
 
 //--- Title string ---
 #define TITLE "Linux block devices benchmark v0.45. Variant 1. (C)2018 IC Book Labs."
@@ -69,6 +104,21 @@
 #define WSYNC 1             // sync write mode default ON (no writeback)
 #define PRECISION 0         // default fast test, not a precision test
 #define MACHINEREADABLE 0   // machine readable output disabled by default
+#define TIMER 0             // time source default is auto
+#define OUTPUT 0            // results format default is console text
+#define CI_TARGET 2         // slow precision median CI width target, percents
+#define MINPASSES 3         // slow precision minimum passes per line
+#define MAXPASSES 20        // slow precision maximum passes per line
+#define BUDGET 0            // slow precision seconds per line, 0 = not limited
+#define PASSES_LIMIT 10000  // maximum of maxpasses
+#define BOOTSTRAP 1000      // bootstrap resamples for median confidence interval
+#define WARMUP_MIN 4        // minimum passes for warm-up detection
+#define DURATION 0          // soak duration, seconds, 0 = not used
+#define INTERVAL 60         // soak summary interval, seconds
+#define DRIFT_BASELINE 20   // lines for drift baseline, after start or drift
+#define DRIFT_K 0.5         // CUSUM slack, baseline standard deviations
+#define DRIFT_H 10.0        // CUSUM alarm threshold, baseline standard deviations
+#define DRIFT_SIGMA_MIN 0.01  // minimum baseline deviation, part of mean
 #define BUFALIGN 4096       // alignment factor, 4KB is page size for x86/x64
 
 #define OPERATION_PER_LINE 1048576*100  // size per line output
@@ -86,6 +136,12 @@ static char* datamodes[] =
 #define n_pr 2
 static char* precisions[] = 
     { "fast", "slow" };
+#define n_tm 3
+static char* timers[] =
+    { "auto", "tsc", "monotonic" };
+#define n_out 3
+static char* outputs[] =
+    { "text", "json", "csv" };
 char pathString[] = "/dev/sda";
 
 //--- Numeric data for storing command line options, with defaults assigned ---
@@ -103,6 +159,14 @@ static int direct = DIRECT;
 static int wsync = WSYNC;
 static int precision = PRECISION;
 static int machinereadable = MACHINEREADABLE;
+static int timer = TIMER;
+static int output = OUTPUT;
+static int ciTarget = CI_TARGET;
+static int minPasses = MINPASSES;
+static int maxPasses = MAXPASSES;
+static int budget = BUDGET;
+static int duration = DURATION;
+static int interval = INTERVAL;
 
 //--- Numeric data for storing scan configuration results ---
 static size_t bufalign = BUFALIGN;
@@ -143,6 +207,26 @@ static char* namesT[] = { nameT0, nameT1, nameT2, nameT3 };
 static struct timespec ts[TCNT];              // reports of timers parameters
 static struct timespec ts1[TCNT], ts2[TCNT];  // start and end moments
 
+//--- Variables for selected time source, used for speed measurement ---
+#define TIMER_AUTO 0                // invariant TSC if supported, otherwise CLOCK_MONOTONIC
+#define TIMER_TSC 1                 // invariant TSC, calibrated against CLOCK_MONOTONIC_RAW
+#define TIMER_MONOTONIC 2           // clock_gettime( CLOCK_MONOTONIC )
+#define TIMER_CALIBRATE 100000000   // TSC calibration interval, nanoseconds
+#define TIMER_PROBES 100000         // number of back-to-back reads for overhead
+static double tscNanoseconds = 0.0;             // nanoseconds per TSC tick
+static unsigned long long tscBase = 0;          // TSC tick at calibration start
+static unsigned long long timerOverhead = 0;    // minimum time of one read, ns
+static unsigned long long timerResolution = 0;  // minimum non-zero step, ns
+static unsigned long long ns1 = 0, ns2 = 0;     // start and end moments, ns
+
+//--- Variables for block device statistics, sysfs stat file of device ---
+#define DEVSTAT_FIELDS 11   // used fields, up to time_in_queue
+#define SECTOR_BYTES 512    // stat file sector units
+static char devStatPath[SMAX];                      // stat file path
+static unsigned long long devStart[DEVSTAT_FIELDS]; // values at run start
+static int devStatus = -1;                          // 0 if start values valid
+static unsigned long long benchBytes = 0;           // bytes moved by benchmark, all lines and passes
+
 //--- Variables for IOCTL requests to block devices ---
 int fd = 0;                     // file descriptor, open device as file
 typedef union                   // data region for IDENTIFY_DEVICE
@@ -165,7 +249,7 @@ typedef struct
     OPTION_TYPES routine;   // select handling method for this entry
     } OPTION_ENTRY;
     
-#define OPTION_COUNT 13     // number of entries for command line options
+#define OPTION_COUNT 21     // number of entries for command line options
 static OPTION_ENTRY option_list[] =
     {
         { "path"            , NULL       , 0     , &path            , STRPARM },
@@ -180,7 +264,15 @@ static OPTION_ENTRY option_list[] =
         { "direct"          , NULL       , 0     , &direct          , INTPARM },
         { "sync"            , NULL       , 0     , &wsync           , INTPARM },
         { "precision"       , precisions , n_pr  , &precision       , SELPARM },
-        { "machinereadable" , NULL       , 0     , &machinereadable , INTPARM }
+        { "machinereadable" , NULL       , 0     , &machinereadable , INTPARM },
+        { "timer"           , timers     , n_tm  , &timer           , SELPARM },
+        { "output"          , outputs    , n_out , &output          , SELPARM },
+        { "ci"              , NULL       , 0     , &ciTarget        , INTPARM },
+        { "minpasses"       , NULL       , 0     , &minPasses       , INTPARM },
+        { "maxpasses"       , NULL       , 0     , &maxPasses       , INTPARM },
+        { "budget"          , NULL       , 0     , &budget          , INTPARM },
+        { "duration"        , NULL       , 0     , &duration        , INTPARM },
+        { "interval"        , NULL       , 0     , &interval        , INTPARM }
     };
 
 //--- Control block for start conditions parameters visual ---
@@ -194,7 +286,7 @@ typedef struct
     PRINT_TYPES routine;    // select handling method for this entry
     } PRINT_ENTRY;
 
-#define PRINT_COUNT 16    // number of entries for print
+#define PRINT_COUNT 24    // number of entries for print
 #define PRINT_NAME  20    // number of chars before "=" for tabulation
 static PRINT_ENTRY print_list[] = 
     {
@@ -211,6 +303,14 @@ static PRINT_ENTRY print_list[] =
         { "Synchronous mode"    , NULL       , &wsync           , INTEGER  },
         { "Precision option"    , precisions , &precision       , SELECTOR },
         { "Machine readable"    , NULL       , &machinereadable , INTEGER  },
+        { "Time source"         , timers     , &timer           , SELECTOR },
+        { "Output format"       , outputs    , &output          , SELECTOR },
+        { "CI target, percents" , NULL       , &ciTarget        , INTEGER  },
+        { "Minimum passes"      , NULL       , &minPasses       , INTEGER  },
+        { "Maximum passes"      , NULL       , &maxPasses       , INTEGER  },
+        { "Line budget, seconds", NULL       , &budget          , INTEGER  },
+        { "Soak duration, sec." , NULL       , &duration        , INTEGER  },
+        { "Soak interval, sec." , NULL       , &interval        , INTEGER  },
         { "Buffer pointer"      , NULL       , &diskData        , POINTER  },
         { "Buffer size"         , NULL       , &bufsize         , MEMSIZE  },
         { "Buffer alignment"    , NULL       , &bufalign        , MEMSIZE  },
@@ -221,6 +321,7 @@ static PRINT_ENTRY print_list[] =
 #define MEGA 1024*1024
 #define GIGA 1024*1024*1024
 #define PRINT_LIMIT 20
+#define MAXVALUE 32         // maximum machine readable value size, chars
 int scratchMemorySize( char* scratchPointer, size_t memsize )
     {
     double xd = memsize;
@@ -282,6 +383,160 @@ void printSelectedString( int select, char* names[] )
     printf( "%s", names[select] );
     }
 
+//--- Variables for machine readable output, records stream is original stdout ---
+#define OUTPUT_TEXT 0       // console text only
+#define OUTPUT_JSON 1       // JSON records at stdout, console text at stderr
+#define OUTPUT_CSV 2        // CSV records at stdout, console text at stderr
+#define OUTPUT_SCHEMA 2     // records schema version, same as mapfile
+static FILE* machineFile = NULL;    // records stream, NULL if text output
+static int machineRecords = 0;      // number of records, for JSON separators
+
+//--- Write one machine readable record ---
+// schema: section, scenario, benchmark, operation, pass, name, value,
+// name converted to lower case, punctuation runs to one underscore,
+// scenario is 0 (no test plan), one benchmark is 1,
+// start conditions and resource usage are benchmark 0,
+// pass = 0 and operation = NULL means not applicable
+void outputRecord( char* section, char* operation, int pass,
+                   const char* name, char* value, int quoted )
+{
+char key[SMAX];
+const char* p = NULL;
+int benchmark = ( strcmp( section, "pass" ) == 0 )||( strcmp( section, "statistics" ) == 0 );
+int i = 0;
+if ( machineFile == NULL ) return;
+for ( p=name; ( *p != 0 )&&( i < ( SMAX - 1 ) ); p++ )
+    {
+    if ( isalnum( (unsigned char)*p ) ) { key[i++] = tolower( (unsigned char)*p ); }
+    else if ( ( i > 0 )&&( key[i-1] != '_' ) ) { key[i++] = '_'; }
+    }
+if ( ( i > 0 )&&( key[i-1] == '_' ) ) { i--; }
+key[i] = 0;
+if ( output == OUTPUT_JSON )
+    {
+    fprintf( machineFile, "%s\n{\"section\":\"%s\",\"scenario\":0,\"benchmark\":%d,",
+             machineRecords ? "," : "", section, benchmark );
+    if ( operation != NULL ) { fprintf( machineFile, "\"operation\":\"%s\",", operation ); }
+    else { fprintf( machineFile, "\"operation\":null," ); }
+    if ( pass > 0 ) { fprintf( machineFile, "\"pass\":%d,", pass ); }
+    else { fprintf( machineFile, "\"pass\":null," ); }
+    fprintf( machineFile, "\"name\":\"%s\",\"value\":", key );
+    if ( quoted ) { fputc( '"', machineFile ); }
+    for ( p=value; *p!=0; p++ )
+        {
+        if ( quoted && ( ( *p == '"' )||( *p == '\\' ) ) ) { fputc( '\\', machineFile ); }
+        if ( (unsigned char)*p >= ' ' ) { fputc( *p, machineFile ); }
+        }
+    fprintf( machineFile, "%s}", quoted ? "\"" : "" );
+    }
+else
+    {
+    fprintf( machineFile, "%s,0,%d,%s,", section, benchmark, operation != NULL ? operation : "" );
+    if ( pass > 0 ) { fprintf( machineFile, "%d", pass ); }
+    fprintf( machineFile, ",%s,", key );
+    if ( quoted ) { fputc( '"', machineFile ); }
+    for ( p=value; *p!=0; p++ )
+        {
+        if ( quoted && ( *p == '"' ) ) { fputc( '"', machineFile ); }
+        fputc( *p, machineFile );
+        }
+    fprintf( machineFile, "%s\n", quoted ? "\"" : "" );
+    }
+machineRecords++;
+}
+
+//--- Write machine readable record with floating point value ---
+void outputDouble( char* section, char* operation, int pass, const char* name, double value )
+{
+char text[MAXVALUE];
+if ( machineFile == NULL ) return;
+snprintf( text, MAXVALUE, "%.9g", value );
+if ( !isfinite( value ) ) 
+    { snprintf( text, MAXVALUE, "%s", output == OUTPUT_JSON ? "null" : "" ); }
+outputRecord( section, operation, pass, name, text, 0 );
+}
+
+//--- Write machine readable record with integer value ---
+void outputInteger( char* section, char* operation, int pass, const char* name, long long value )
+{
+char text[MAXVALUE];
+if ( machineFile == NULL ) return;
+snprintf( text, MAXVALUE, "%lld", value );
+outputRecord( section, operation, pass, name, text, 0 );
+}
+
+//--- Write start conditions as machine readable records, raw values ---
+void outputConditions()
+{
+char text[MAXVALUE];
+int i = 0;
+if ( machineFile == NULL ) return;
+for ( i=0; i<PRINT_COUNT; i++ )
+    {
+    switch( print_list[i].routine )
+        {
+        case INTEGER:
+            outputInteger( "condition", NULL, 0, print_list[i].name, *(int*)print_list[i].data );
+            break;
+        case MEMSIZE:
+            outputInteger( "condition", NULL, 0, print_list[i].name, *(size_t*)print_list[i].data );
+            break;
+        case SELECTOR:
+            outputRecord( "condition", NULL, 0, print_list[i].name,
+                          print_list[i].values[*(int*)print_list[i].data], 1 );
+            break;
+        case POINTER:
+            snprintf( text, MAXVALUE, "%p", *(void**)print_list[i].data );
+            outputRecord( "condition", NULL, 0, print_list[i].name, text, 1 );
+            break;
+        case HEX64:
+        case MHZ:
+            outputInteger( "condition", NULL, 0, print_list[i].name, *(unsigned long long*)print_list[i].data );
+            break;
+        case STRNG:
+            outputRecord( "condition", NULL, 0, print_list[i].name, *(char**)print_list[i].data, 1 );
+            break;
+        }
+    }
+}
+
+//--- Close machine readable records stream, at exit ---
+void outputClose()
+{
+if ( machineFile == NULL ) return;
+fflush( stdout );
+if ( output == OUTPUT_JSON ) { fprintf( machineFile, "\n]}\n" ); }
+fclose( machineFile );
+machineFile = NULL;
+}
+
+//--- Open machine readable records stream ---
+// records written to original stdout, console text moved to stderr,
+// stream closed at exit, so JSON document valid if run stopped by error
+void outputOpen()
+{
+int handle = 0;
+if ( output == OUTPUT_TEXT ) return;
+fflush( stdout );
+handle = dup( STDOUT_FILENO );
+if ( ( handle < 0 )||( dup2( STDERR_FILENO, STDOUT_FILENO ) < 0 )||
+     ( ( machineFile = fdopen( handle, "w" ) ) == NULL ) )
+    {
+    printf( "ERROR, OUTPUT REDIRECTION FAILED ( %s )\n", strerror(errno) );
+    exit(1);
+    }
+if ( output == OUTPUT_JSON )
+    {
+    fprintf( machineFile, "{\"tool\":\"blockbench\",\"version\":\"0.45\",\"schema\":%d,\"records\":[",
+             OUTPUT_SCHEMA );
+    }
+else
+    {
+    fprintf( machineFile, "section,scenario,benchmark,operation,pass,name,value\n" );
+    }
+atexit( outputClose );
+}
+
 //--- Detect, store and print OS timers configuration ---
 void detectAndPrintTimers()
 {
@@ -308,6 +563,147 @@ for ( i=0; i<TCNT; i++ )
     }
 }
 
+//--- Read selected time source, nanoseconds ---
+static inline unsigned long long readNanoseconds()
+{
+struct timespec t;
+#ifdef TIMER_X86
+if ( timer == TIMER_TSC )
+    {
+    _mm_lfence();  // previous operations completed before TSC read
+    return ( __rdtsc() - tscBase ) * tscNanoseconds;
+    }
+#endif
+clock_gettime( CLOCK_MONOTONIC, &t );
+return (unsigned long long)t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+//--- Measured interval, nanoseconds, time source read overhead subtracted, not below 0 ---
+static inline unsigned long long intervalNanoseconds( unsigned long long t1, unsigned long long t2 )
+{
+unsigned long long ns = t2 - t1;
+return ns > timerOverhead ? ns - timerOverhead : 0;
+}
+
+//--- Select and calibrate time source, measure read overhead and resolution ---
+// TSC calibrated by busy wait of CLOCK_MONOTONIC_RAW, not adjusted by NTP,
+// returns 0 if selected time source supported, 1 if not supported
+int detectAndPrintTimeSource()
+{
+unsigned long long t1 = 0, t2 = 0, delta = 0;
+int i = 0;
+#ifdef TIMER_X86
+unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+int invariant = 0;
+struct timespec raw1, raw2;
+unsigned long long tsc1 = 0, tsc2 = 0;
+double rawSeconds = 0.0;
+if ( __get_cpuid( 0x80000007, &eax, &ebx, &ecx, &edx ) ) 
+    { invariant = ( edx >> 8 ) & 1; }
+if ( timer == TIMER_AUTO ) { timer = invariant ? TIMER_TSC : TIMER_MONOTONIC; }
+if ( timer == TIMER_TSC )
+    {
+    if ( !invariant ) return 1;
+    clock_gettime( CLOCK_MONOTONIC_RAW, &raw1 );
+    tsc1 = __rdtsc();
+    do  {
+        clock_gettime( CLOCK_MONOTONIC_RAW, &raw2 );
+        tsc2 = __rdtsc();
+        rawSeconds = ( raw2.tv_sec - raw1.tv_sec ) + 
+                     ( raw2.tv_nsec - raw1.tv_nsec ) / 1000000000.0;
+        } while ( rawSeconds < TIMER_CALIBRATE / 1000000000.0 );
+    tscNanoseconds = rawSeconds * 1000000000.0 / ( tsc2 - tsc1 );
+    tscBase = tsc1;
+    printf( "Invariant TSC  %.3f MHz, calibrated by CLOCK_MONOTONIC_RAW\n",
+            1000.0 / tscNanoseconds );
+    }
+#else
+if ( timer == TIMER_AUTO ) { timer = TIMER_MONOTONIC; }
+if ( timer == TIMER_TSC ) return 1;
+#endif
+timerOverhead = ~0ULL;
+timerResolution = ~0ULL;
+for ( i=0; i<TIMER_PROBES; i++ )
+    {
+    t1 = readNanoseconds();
+    t2 = readNanoseconds();
+    delta = t2 - t1;
+    if ( delta < timerOverhead ) { timerOverhead = delta; }
+    if ( ( delta != 0 )&&( delta < timerResolution ) ) { timerResolution = delta; }
+    }
+if ( timerResolution == ~0ULL ) { timerResolution = 0; }
+printf( "Time source: %s, read overhead %llu ns, resolution %llu ns\n",
+        timers[timer], timerOverhead, timerResolution );
+outputInteger( "condition", NULL, 0, "timer overhead ns", timerOverhead );
+outputInteger( "condition", NULL, 0, "timer resolution ns", timerResolution );
+return 0;
+}
+
+//--- Read block device stat file, returns 0 if OK ---
+int readDeviceStat( unsigned long long* values )
+{
+FILE* statFile = NULL;
+int i = 0, count = 0;
+statFile = fopen( devStatPath, "r" );
+if ( statFile == NULL ) return -1;
+for ( i=0; i<DEVSTAT_FIELDS; i++ ) 
+    { count += fscanf( statFile, "%llu", &values[i] ); }
+fclose( statFile );
+return ( count == DEVSTAT_FIELDS ) ? 0 : -1;
+}
+
+//--- Resolve stat file of block device by st_rdev, get start values ---
+void startDeviceStat( char* devicePath )
+{
+struct stat info;
+devStatus = -1;
+if ( stat( devicePath, &info ) != 0 ) return;
+if ( !S_ISBLK( info.st_mode ) ) return;
+snprintf( devStatPath, SMAX, "/sys/dev/block/%u:%u/stat",
+          major( info.st_rdev ), minor( info.st_rdev ) );
+devStatus = readDeviceStat( devStart );
+}
+
+//--- Get end values of block device statistics, print deltas ---
+void stopAndPrintDeviceStat()
+{
+unsigned long long values[DEVSTAT_FIELDS];
+long long d[DEVSTAT_FIELDS];
+long long ios = 0;
+int i = 0;
+printf ( "\nDevice statistics (%s):\n", devStatPath );
+if ( ( devStatus != 0 )||( readDeviceStat( values ) != 0 ) )
+    {
+    printf( "n/a\n" );
+    return;
+    }
+for ( i=0; i<DEVSTAT_FIELDS; i++ ) { d[i] = values[i] - devStart[i]; }
+ios = d[0] + d[4];
+printf( "Read  IOs=%lld , KB=%.0f , Average KB=%.1f\n", d[0],
+        d[2] * SECTOR_BYTES / 1024.0,
+        d[0] > 0 ? d[2] * SECTOR_BYTES / 1024.0 / d[0] : 0.0 );
+printf( "Write IOs=%lld , KB=%.0f , Average KB=%.1f\n", d[4],
+        d[6] * SECTOR_BYTES / 1024.0,
+        d[4] > 0 ? d[6] * SECTOR_BYTES / 1024.0 / d[4] : 0.0 );
+printf( "Queue ms=%lld , Wait ms per IO=%.3f\n", d[10],
+        ios > 0 ? (double)( d[3] + d[7] ) / ios : 0.0 );
+outputInteger( "statistics", "device", 0, "read ios", d[0] );
+outputInteger( "statistics", "device", 0, "read bytes", d[2] * SECTOR_BYTES );
+outputInteger( "statistics", "device", 0, "write ios", d[4] );
+outputInteger( "statistics", "device", 0, "write bytes", d[6] * SECTOR_BYTES );
+outputInteger( "statistics", "device", 0, "queue ms", d[10] );
+if ( benchBytes > 0 )
+    {
+    printf( "Benchmark KB=%.0f , Read amplification=%.3f , Write amplification=%.3f\n",
+            benchBytes / 1024.0,
+            (double)d[2] * SECTOR_BYTES / benchBytes,
+            (double)d[6] * SECTOR_BYTES / benchBytes );
+    outputInteger( "statistics", "device", 0, "benchmark bytes", benchBytes );
+    outputDouble( "statistics", "device", 0, "read amplification", (double)d[2] * SECTOR_BYTES / benchBytes );
+    outputDouble( "statistics", "device", 0, "write amplification", (double)d[6] * SECTOR_BYTES / benchBytes );
+    }
+}
+
 //--- Called at start of measured interval ---
 void startTimeDelta()
 {
@@ -329,6 +725,7 @@ for ( i=0; i<TCNT; i++ )
         ts1[i].tv_nsec = -1;
         }
     }
+ns1 = readNanoseconds();  // last, OS timers reads not in measured interval
 }
 
 //--- Called at end of measured interval ---
@@ -336,6 +733,7 @@ void stopTimeDelta()
 {
 int i = 0;
 int timerStatus = 0;
+ns2 = readNanoseconds();  // first, OS timers reads not in measured interval
 for ( i=0; i<TCNT; i++ )
     {
     if ( ts1[i].tv_sec >= 0 )  // validation from get start time
@@ -354,6 +752,301 @@ for ( i=0; i<TCNT; i++ )
     }
 }
 
+//--- Select k-th smallest value, quickselect, array reordered ---
+double selectValue( double* data, int count, int k )
+{
+int left = 0, right = count - 1;
+int i = 0, j = 0;
+double pivot = 0.0, temp = 0.0;
+while ( left < right )
+    {
+    pivot = data[ left + ( right - left ) / 2 ];
+    i = left;
+    j = right;
+    while ( i <= j )
+        {
+        while ( data[i] < pivot ) i++;
+        while ( data[j] > pivot ) j--;
+        if ( i <= j )
+            {
+            temp = data[i];
+            data[i] = data[j];
+            data[j] = temp;
+            i++;
+            j--;
+            }
+        }
+    if ( k <= j ) { right = j; }
+    else if ( k >= i ) { left = i; }
+    else break;
+    }
+return data[k];
+}
+
+//--- Percentile by linear interpolation between closest ranks, array reordered ---
+double percentileValue( double* data, int count, double p )
+{
+double h = ( count - 1 ) * p;
+int lo = (int)h;
+int i = 0;
+double x = selectValue( data, count, lo );
+double y = 0.0;
+if ( ( h > lo )&&( ( lo + 1 ) < count ) )
+    {
+    y = data[lo + 1];
+    for ( i=lo+2; i<count; i++ ) { if ( data[i] < y ) y = data[i]; }
+    x += ( h - lo ) * ( y - x );
+    }
+return x;
+}
+
+//--- Number of leading warm-up passes by MSER rule, same as mapfile ---
+// d from 0 to count/2 for minimum of sum( ( x[i] - mean )^2 ) / ( count - d )^2
+int detectWarmup( double* data, int count )
+{
+double sum = 0.0, sumSquares = 0.0, score = 0.0, best = -1.0, n = 0.0;
+int warmup = 0;
+int i = 0;
+if ( count < WARMUP_MIN ) return 0;
+for ( i=count-1; i>=0; i-- )
+    {
+    sum += data[i];
+    sumSquares += data[i] * data[i];
+    if ( i > ( count / 2 ) ) continue;
+    n = count - i;
+    score = ( sumSquares - sum * sum / n ) / ( n * n );
+    if ( ( best < 0.0 )||( score <= best ) )
+        {
+        best = score;
+        warmup = i;
+        }
+    }
+return warmup;
+}
+
+//--- Median and its 95% confidence interval by bootstrap, fixed seed ---
+// scratch = work array of count entries, data not reordered,
+// returns median, updates ciLow and ciHigh
+double medianInterval( double* data, int count, double* scratch,
+                       double* ciLow, double* ciHigh )
+{
+static double medians[BOOTSTRAP];
+unsigned long long random = 0x9E3779B97F4A7C15ULL;
+double median = 0.0;
+int i = 0, b = 0;
+for ( i=0; i<count; i++ ) { scratch[i] = data[i]; }
+median = percentileValue( scratch, count, 0.5 );
+for ( b=0; b<BOOTSTRAP; b++ )
+    {
+    for ( i=0; i<count; i++ )
+        {
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        scratch[i] = data[ random % count ];
+        }
+    medians[b] = percentileValue( scratch, count, 0.5 );
+    }
+*ciLow = percentileValue( medians, BOOTSTRAP, 0.025 );
+*ciHigh = percentileValue( medians, BOOTSTRAP, 0.975 );
+return median;
+}
+
+//--- Streaming quantile, P-square algorithm, same as mapfile ---
+typedef struct
+    {
+    double p;               // quantile, from 0.0 to 1.0
+    double q[5];            // markers heights, first samples before 5 samples
+    double n[5];            // markers positions, 1-based
+    double np[5];           // desired markers positions
+    double dn[5];           // desired positions increments
+    long long count;        // number of samples
+    } P2_QUANTILE;
+
+//--- Streaming statistics, Welford mean and variance, P-square quantiles ---
+typedef struct
+    {
+    long long count;
+    double mean, m2, minimum, maximum;
+    P2_QUANTILE p5, p50, p95;
+    } STREAM_STAT;
+
+//--- Drift detection, two-sided CUSUM against baseline, same as mapfile ---
+typedef struct
+    {
+    STREAM_STAT baseline;           // baseline lines, after start or after last drift
+    double high, low;               // cumulative sums, baseline standard deviations
+    double highSum, lowSum;         // samples since cumulative sum was zero
+    long long highCount, lowCount;
+    int drifts;                     // number of detected drifts
+    } DRIFT_STATE;
+
+void p2Clear( P2_QUANTILE* quantile, double p )
+{
+memset( quantile, 0, sizeof( P2_QUANTILE ) );
+quantile->p = p;
+quantile->dn[1] = p / 2.0;
+quantile->dn[2] = p;
+quantile->dn[3] = ( 1.0 + p ) / 2.0;
+quantile->dn[4] = 1.0;
+}
+
+void p2Add( P2_QUANTILE* quantile, double x )
+{
+double* q = quantile->q;
+double* n = quantile->n;
+double d = 0.0, qp = 0.0;
+int i = 0, k = 0, ds = 0;
+if ( quantile->count < 5 )
+    {
+    q[quantile->count++] = x;
+    if ( quantile->count < 5 ) return;
+    for ( i=1; i<5; i++ )
+        {
+        for ( k=i; ( k>0 )&&( q[k-1] > q[k] ); k-- ) { d = q[k]; q[k] = q[k-1]; q[k-1] = d; }
+        }
+    for ( i=0; i<5; i++ ) { n[i] = i + 1; }
+    quantile->np[0] = 1.0;
+    quantile->np[1] = 1.0 + 2.0 * quantile->p;
+    quantile->np[2] = 1.0 + 4.0 * quantile->p;
+    quantile->np[3] = 3.0 + 2.0 * quantile->p;
+    quantile->np[4] = 5.0;
+    return;
+    }
+if ( x < q[0] ) { q[0] = x; k = 0; }
+else if ( x >= q[4] ) { q[4] = x; k = 3; }
+else { for ( k=0; ( k<3 )&&( x >= q[k+1] ); k++ ); }
+for ( i=k+1; i<5; i++ ) { n[i] += 1.0; }
+for ( i=0; i<5; i++ ) { quantile->np[i] += quantile->dn[i]; }
+for ( i=1; i<4; i++ )
+    {
+    d = quantile->np[i] - n[i];
+    if ( ( ( d >= 1.0 )&&( ( n[i+1] - n[i] ) > 1.0 ) )||( ( d <= -1.0 )&&( ( n[i-1] - n[i] ) < -1.0 ) ) )
+        {
+        ds = ( d >= 0.0 ) ? 1 : -1;
+        qp = q[i] + ds / ( n[i+1] - n[i-1] ) *
+             ( ( n[i] - n[i-1] + ds ) * ( q[i+1] - q[i] ) / ( n[i+1] - n[i] ) +
+               ( n[i+1] - n[i] - ds ) * ( q[i] - q[i-1] ) / ( n[i] - n[i-1] ) );
+        if ( ( qp <= q[i-1] )||( qp >= q[i+1] ) )
+            {
+            qp = q[i] + ds * ( q[i+ds] - q[i] ) / ( n[i+ds] - n[i] );
+            }
+        q[i] = qp;
+        n[i] += ds;
+        }
+    }
+quantile->count++;
+}
+
+double p2Value( P2_QUANTILE* quantile )
+{
+double first[5];
+int i = 0;
+if ( quantile->count >= 5 ) return quantile->q[2];
+if ( quantile->count == 0 ) return 0.0;
+for ( i=0; i<quantile->count; i++ ) { first[i] = quantile->q[i]; }
+return percentileValue( first, quantile->count, quantile->p );
+}
+
+void streamClear( STREAM_STAT* stat )
+{
+stat->count = 0;
+stat->mean = 0.0;
+stat->m2 = 0.0;
+stat->minimum = 0.0;
+stat->maximum = 0.0;
+p2Clear( &stat->p5, 0.05 );
+p2Clear( &stat->p50, 0.5 );
+p2Clear( &stat->p95, 0.95 );
+}
+
+void streamAdd( STREAM_STAT* stat, double x )
+{
+double delta = x - stat->mean;
+if ( ( stat->count == 0 )||( x < stat->minimum ) ) { stat->minimum = x; }
+if ( ( stat->count == 0 )||( x > stat->maximum ) ) { stat->maximum = x; }
+stat->count++;
+stat->mean += delta / stat->count;
+stat->m2 += delta * ( x - stat->mean );
+p2Add( &stat->p5, x );
+p2Add( &stat->p50, x );
+p2Add( &stat->p95, x );
+}
+
+double streamStddev( STREAM_STAT* stat )
+{
+if ( stat->count < 2 ) return NAN;
+return sqrt( stat->m2 / ( stat->count - 1 ) );
+}
+
+//--- Returns 1 if drift detected, old and new level, samples since change point ---
+int driftAdd( DRIFT_STATE* drift, double x, double* oldLevel, double* newLevel, long long* changeSamples )
+{
+double sigma = 0.0, z = 0.0;
+if ( drift->baseline.count < DRIFT_BASELINE )
+    {
+    streamAdd( &drift->baseline, x );
+    return 0;
+    }
+sigma = streamStddev( &drift->baseline );
+if ( !( sigma >= DRIFT_SIGMA_MIN * fabs( drift->baseline.mean ) ) )
+    {
+    sigma = DRIFT_SIGMA_MIN * fabs( drift->baseline.mean );
+    }
+if ( sigma <= 0.0 ) return 0;
+z = ( x - drift->baseline.mean ) / sigma;
+drift->high += z - DRIFT_K;
+drift->low += -z - DRIFT_K;
+if ( drift->high <= 0.0 ) { drift->high = 0.0; drift->highSum = 0.0; drift->highCount = 0; }
+else { drift->highSum += x; drift->highCount++; }
+if ( drift->low <= 0.0 ) { drift->low = 0.0; drift->lowSum = 0.0; drift->lowCount = 0; }
+else { drift->lowSum += x; drift->lowCount++; }
+if ( ( drift->high <= DRIFT_H )&&( drift->low <= DRIFT_H ) ) return 0;
+if ( drift->high > DRIFT_H )
+    {
+    *newLevel = drift->highSum / drift->highCount;
+    *changeSamples = drift->highCount;
+    }
+else
+    {
+    *newLevel = drift->lowSum / drift->lowCount;
+    *changeSamples = drift->lowCount;
+    }
+*oldLevel = drift->baseline.mean;
+drift->drifts++;
+streamClear( &drift->baseline );
+drift->high = 0.0;
+drift->low = 0.0;
+drift->highSum = 0.0;
+drift->lowSum = 0.0;
+drift->highCount = 0;
+drift->lowCount = 0;
+return 1;
+}
+
+//--- Print soak summary, interval mean then all lines, write records ---
+void printSoakSummary( STREAM_STAT* total, STREAM_STAT* part, DRIFT_STATE* drift,
+                       double seconds, int summary )
+{
+char* section = ( summary == 0 ) ? "statistics" : "soak";
+printf( "\n%s %d, %.1f s: lines=%lld , interval mean=%.2f , mean=%.2f , stddev=%.2f ,\n"
+        "P5=%.2f , median=%.2f , P95=%.2f , min=%.2f , max=%.2f , drifts=%d\n\n",
+        summary == 0 ? "Soak totals" : "Soak summary", summary, seconds,
+        total->count, part->mean, total->mean, streamStddev( total ),
+        p2Value( &total->p5 ), p2Value( &total->p50 ), p2Value( &total->p95 ),
+        total->minimum, total->maximum, drift->drifts );
+outputInteger( section, operations[operation], summary, "lines", total->count );
+if ( summary != 0 ) { outputDouble( section, operations[operation], summary, "interval_mean", part->mean ); }
+outputDouble( section, operations[operation], summary, "mean", total->mean );
+outputDouble( section, operations[operation], summary, "stddev", streamStddev( total ) );
+outputDouble( section, operations[operation], summary, "p5", p2Value( &total->p5 ) );
+outputDouble( section, operations[operation], summary, "median", p2Value( &total->p50 ) );
+outputDouble( section, operations[operation], summary, "p95", p2Value( &total->p95 ) );
+outputDouble( section, operations[operation], summary, "minimum", total->minimum );
+outputDouble( section, operations[operation], summary, "maximum", total->maximum );
+outputInteger( section, operations[operation], summary, "drifts", drift->drifts );
+}
+
 //--- Get and print Linux application statistics ---
 void printStatistics()
 {
@@ -384,6 +1077,19 @@ printf ( "IPC messages received            = %ld\n", usage.ru_msgrcv );
 printf ( "Signals received                 = %ld\n", usage.ru_nsignals );
 printf ( "Voluntary context switches       = %ld\n", usage.ru_nvcsw );
 printf ( "Involuntary context switches     = %ld\n", usage.ru_nivcsw );
+outputInteger( "rusage", NULL, 0, "utime us", 
+               (long long)usage.ru_utime.tv_sec * 1000000 + usage.ru_utime.tv_usec );
+outputInteger( "rusage", NULL, 0, "stime us", 
+               (long long)usage.ru_stime.tv_sec * 1000000 + usage.ru_stime.tv_usec );
+outputInteger( "rusage", NULL, 0, "maxrss kb", usage.ru_maxrss );
+outputInteger( "rusage", NULL, 0, "minflt", usage.ru_minflt );
+outputInteger( "rusage", NULL, 0, "majflt", usage.ru_majflt );
+outputInteger( "rusage", NULL, 0, "nswap", usage.ru_nswap );
+outputInteger( "rusage", NULL, 0, "inblock", usage.ru_inblock );
+outputInteger( "rusage", NULL, 0, "oublock", usage.ru_oublock );
+outputInteger( "rusage", NULL, 0, "nsignals", usage.ru_nsignals );
+outputInteger( "rusage", NULL, 0, "nvcsw", usage.ru_nvcsw );
+outputInteger( "rusage", NULL, 0, "nivcsw", usage.ru_nivcsw );
 }
 
 //--- Names of tests ---
@@ -398,9 +1104,6 @@ static int bytesPerInstruction[] =
 
 int main( int argc, char** argv )
 {
-//--- Start message ---
-printf ( "\n%s\n\n", TITLE );
-
 //--- Initializing pseudo constant ---
 strcpy ( pathBuffer, PATH );
 
@@ -571,10 +1274,22 @@ for ( i=1; i<argc; i++ )        // cycle for command line options
         exit(1);
         }
     }
+
+//--- Open machine readable output, machinereadable=1 is alias of output=csv ---
+if ( ( machinereadable != 0 )&&( output == OUTPUT_TEXT ) ) { output = OUTPUT_CSV; }
+outputOpen();
+
+//--- Start message ---
+printf ( "\n%s\n\n", TITLE );
     
 //--- Detect OS timers, print results ---
 printf( "OS timers list with resolutions:\n" );
 detectAndPrintTimers();
+if ( detectAndPrintTimeSource() != 0 )
+    {
+    printf( "\nERROR, TIMER NOT SUPPORTED: tsc requires invariant TSC\n" );
+    exit(2);
+    }
 
 //--- Detect OS block device, print results ---
 printf( "\nDetect block device...\n" );
@@ -760,6 +1475,7 @@ for ( i=0; i<PRINT_COUNT; i++ )
         }
     printf("\n");
     }
+outputConditions();
 
 //--- Check start parameters validity and compatibility ---
 
@@ -815,15 +1531,17 @@ if ( wsync != 1 )
     exit(1);
     }
 
-if ( precision != 0 )
+if ( ( duration < 0 )||( interval < 1 ) )
     {
-    printf("\nBAD PARAMETER: precision control not supported yet.\n");
+    printf("\nBAD PARAMETER: duration must be 0 or above, interval 1 or above.\n" );
     exit(1);
     }
-    
-if ( machinereadable != 0 )
+
+if ( ( ciTarget < 1 )||( ciTarget > 100 )||( minPasses < 1 )||
+     ( maxPasses < minPasses )||( maxPasses > PASSES_LIMIT )||( budget < 0 ) )
     {
-    printf("\nBAD PARAMETER: machine readable output not supported yet.\n");
+    printf("\nBAD PARAMETER: ci must be 1-100, minpasses 1-maxpasses, maxpasses up to %d, budget 0 or above.\n",
+           PASSES_LIMIT );
     exit(1);
     }
 
@@ -843,8 +1561,12 @@ if ( key != 'y' )
 //--- Target benchmark operation with time measurement, print results ---
 printf( "\nBenchmarking (%s)...\n" , testsNames[operation] );
 printf( "\n Offset      Size         MBPS          Utilization" );
+if ( precision != 0 ) { printf( "   Passes  Warm-up  CI %%" ); }
 printf( "\n---------------------------------------------------------\n" );
 
+//--- Block device statistics at start ---
+startDeviceStat( path );
+
 //--- Variables for Block I/O benchmarks ---
 size_t varOffset = 0;                    // offset, modified in cycle
 size_t varSize = 0;                      // size of operation per output line
@@ -856,6 +1578,46 @@ double mbps = 0.0;                           // megabytes per second
 double timeTotal = 0.0, timeUtilized = 0.0;  // total and utilized time
 double utilization = 0.0;                    // processor utilization
 
+//--- Variables for slow precision, passes of one line ---
+double* passArray = NULL;                    // MBPS of each pass
+double* passScratch = NULL;                  // work array for median selection
+double utilizationSum = 0.0;                 // sum of passes utilization
+double ciLow = 0.0, ciHigh = 0.0;            // median confidence interval
+double ciWidth = 0.0;                        // interval width, percents of median
+unsigned long long lineStart = 0;            // line start, nanoseconds
+int passCount = 0;                           // number of passes done
+int warmup = 0;                              // number of warm-up passes
+passArray = (double*) malloc( maxPasses * sizeof(double) * 2 );
+if ( passArray == NULL )
+    {
+    printf( "%s ( %s )\n", "PASSES MEMORY ALLOCATION ERROR", strerror(errno) );
+    exit(1);
+    }
+passScratch = passArray + maxPasses;
+
+//--- Variables for soak mode, constant memory statistics ---
+STREAM_STAT soakTotal;                       // all lines
+STREAM_STAT soakPart;                        // lines of current summary interval
+DRIFT_STATE soakDrift;                       // drift detection state, by sweeps MBPS
+double oldLevel = 0.0, newLevel = 0.0;       // drift levels, MBPS
+long long changeSweeps = 0;                  // sweeps since change point
+double sweepBytes = 0.0;                     // bytes of current start..stop sweep
+double sweepTime = 0.0;                      // time of current sweep, bytes / MBPS units
+int sweepCount = 0;                          // number of full sweeps
+unsigned long long soakStart = readNanoseconds();
+unsigned long long summaryStart = soakStart;
+int soakSummaries = 0;                       // number of periodic summaries
+size_t nextOffset = 0;                       // next line offset
+streamClear( &soakTotal );
+streamClear( &soakPart );
+memset( &soakDrift, 0, sizeof( DRIFT_STATE ) );
+streamClear( &soakDrift.baseline );
+if ( ( duration > 0 )&&( lseek( fd, start, SEEK_SET ) < 0 ) )
+    {
+    printf( "%s ( %s )\n", "SEEK ERROR", strerror(errno) );
+    exit(1);
+    }
+
 //--- Variables for statistics ---
 int statCount = 0;                           // counter used for statistics
 // DEBUG, DYNAMICAL ALLOCATION REQUIRED
@@ -873,8 +1635,8 @@ char  scratchLine[MAXLINE];     // scratch buffer for line
 char* scratchPointer = NULL;    // pointer for scratch buffer addressing
 size_t spaces = 0;              // calculated for tabulations
 
-//--- Cycle for required zone of block device ---
-for ( varOffset = start; varOffset < stop; varOffset += varSize )
+//--- Cycle for required zone of block device, repeated until duration expired if soak ---
+for ( varOffset = start; varOffset < stop; varOffset = nextOffset )
     {
     // blank scratch line, initialize pointer
     for ( i=0; i<MAXLINE; i++ ) { scratchLine[i] = 0; }
@@ -894,43 +1656,77 @@ for ( varOffset = start; varOffset < stop; varOffset += varSize )
     spaces = scratchMemorySize( scratchPointer, varSize ); 
     scratchPointer += spaces;
     
-    // read requested block with benchmarking
-    // get start time
-    startTimeDelta();
-    //read
-    accum = 0;
-    while ( accum < varSize )
-        {
-        status = read( fd, diskData, block );
-        if ( status < 0 )
+    // passes of this line, one pass if fast precision
+    passCount = 0;
+    warmup = 0;
+    ciWidth = 0.0;
+    utilizationSum = 0.0;
+    lineStart = readNanoseconds();
+    while ( passCount < maxPasses )
+        {
+        // slow precision re-reads same zone
+        if ( ( precision != 0 )&&( lseek( fd, varOffset, SEEK_SET ) < 0 ) )
             {
-            printf( "%s ( %s )\n", "BLOCK READ ERROR", strerror(errno) );
+            printf( "%s ( %s )\n", "SEEK ERROR", strerror(errno) );
             exit(1);
             }
-        if ( status == 0 )
+        // read requested block with benchmarking
+        // get start time
+        startTimeDelta();
+        //read
+        accum = 0;
+        while ( accum < varSize )
             {
-            printf( "%s ( %s )\n", "UNEXPECTED ZERO LENGTH", strerror(errno) );
-            exit(1);
+            status = read( fd, diskData, block );
+            if ( status < 0 )
+                {
+                printf( "%s ( %s )\n", "BLOCK READ ERROR", strerror(errno) );
+                exit(1);
+                }
+            if ( status == 0 )
+                {
+                printf( "%s ( %s )\n", "UNEXPECTED ZERO LENGTH", strerror(errno) );
+                exit(1);
+                }
+            accum += status;
+            }
+        // get stop time
+        stopTimeDelta();
+        benchBytes += accum;
+        
+        // calculate megabytes per second, selected time source, overhead subtracted
+        seconds = intervalNanoseconds( ns1, ns2 ) / 1000000000.0;
+        megabytes = varSize;
+        megabytes /= 1048576.0;
+        mbps = seconds > 0.0 ? megabytes / seconds : 0.0;
+        // calculate CPU utilization
+        timeTotal = seconds;
+        seconds = ts2[2].tv_sec - ts1[2].tv_sec;
+        nanoseconds = ts2[2].tv_nsec - ts1[2].tv_nsec;
+        seconds += nanoseconds / 1000000000.0;        // add nanoseconds
+        timeUtilized = seconds;
+        utilization = timeUtilized / timeTotal;
+        passArray[passCount] = mbps;
+        utilizationSum += utilization;
+        passCount++;
+        if ( precision == 0 ) break;
+        // slow precision, convergence check with warm-up passes excluded
+        warmup = detectWarmup( passArray, passCount );
+        if ( ( passCount - warmup ) >= minPasses )
+            {
+            mbps = medianInterval( passArray + warmup, passCount - warmup, passScratch, &ciLow, &ciHigh );
+            ciWidth = ( ciHigh - ciLow ) * 100.0 / mbps;
+            if ( ciWidth <= ciTarget ) break;
             }
-        accum += status;
+        if ( ( budget > 0 )&&( ( readNanoseconds() - lineStart ) >= budget * 1000000000ULL ) ) break;
+        }
+    // slow precision line result is median of passes after warm-up
+    if ( precision != 0 )
+        {
+        mbps = medianInterval( passArray + warmup, passCount - warmup, passScratch, &ciLow, &ciHigh );
+        ciWidth = ( ciHigh - ciLow ) * 100.0 / mbps;
+        utilization = utilizationSum / passCount;
         }
-    // get stop time
-    stopTimeDelta();
-    
-    // calculate megabytes per second
-    seconds = ts2[0].tv_sec - ts1[0].tv_sec;
-    nanoseconds = ts2[0].tv_nsec - ts1[0].tv_nsec;
-    seconds += nanoseconds / 1000000000.0;        // add nanoseconds
-    megabytes = varSize;
-    megabytes /= 1048576.0;
-    mbps = megabytes / seconds;
-    // calculate CPU utilization
-    timeTotal = seconds;
-    seconds = ts2[2].tv_sec - ts1[2].tv_sec;
-    nanoseconds = ts2[2].tv_nsec - ts1[2].tv_nsec;
-    seconds += nanoseconds / 1000000000.0;        // add nanoseconds
-    timeUtilized = seconds;
-    utilization = timeUtilized / timeTotal;
     // print megabytes per second
     spaces = 13 - spaces;
     for (i=0; i<spaces; i++ )
@@ -941,25 +1737,108 @@ for ( varOffset = start; varOffset < stop; varOffset += varSize )
     spaces = 14 - spaces;
     for (i=0; i<spaces; i++ ) 
         { scratchPointer += snprintf( scratchPointer, 2, " " ); }
-    snprintf( scratchPointer, MAXENTRY, "%.3f", utilization ); 
+    spaces = snprintf( scratchPointer, MAXENTRY, "%.3f", utilization ); 
+    scratchPointer += spaces;
+    // print passes, warm-up and confidence interval width for slow precision
+    if ( precision != 0 )
+        {
+        spaces = 14 - spaces;
+        for (i=0; i<spaces; i++ )
+            { scratchPointer += snprintf( scratchPointer, 2, " " ); }
+        snprintf( scratchPointer, MAXENTRY * 2, "%-8d %-8d %.2f", passCount, warmup, ciWidth );
+        }
     // output one current line to console
     // better one string built with all previous entries 
     printf( "%s\n", scratchLine );
     
-    // statistics support at cycle
-    statArray[statCount] = mbps;
+    // statistics support at cycle, streaming statistics if soak
+    if ( duration == 0 ) { statArray[statCount] = mbps; }
     statCount++;
+    outputInteger( "pass", operations[operation], statCount, "offset", varOffset );
+    outputInteger( "pass", operations[operation], statCount, "size", varSize );
+    outputDouble( "pass", operations[operation], statCount, "mbps", mbps );
+    outputDouble( "pass", operations[operation], statCount, "utilization", utilization );
+    if ( precision != 0 )
+        {
+        outputInteger( "pass", operations[operation], statCount, "passes", passCount );
+        outputInteger( "pass", operations[operation], statCount, "warmup", warmup );
+        outputDouble( "pass", operations[operation], statCount, "ci_width_percent", ciWidth );
+        }
     
+    // soak mode: streaming statistics, drift detection, periodic summary
+    nextOffset = varOffset + varSize;
+    if ( duration > 0 )
+        {
+        streamAdd( &soakTotal, mbps );
+        streamAdd( &soakPart, mbps );
+        // drift detection by full sweeps, lines of different zones not compared
+        if ( mbps > 0.0 )
+            {
+            sweepBytes += varSize;
+            sweepTime += varSize / mbps;
+            }
+        if ( ( nextOffset >= stop )&&( sweepTime > 0.0 ) )
+            {
+            sweepCount++;
+            if ( driftAdd( &soakDrift, sweepBytes / sweepTime, &oldLevel, &newLevel, &changeSweeps ) )
+                {
+                printf( "\n DRIFT: sweep %d, %.1f s, %.2f MBPS -> %.2f MBPS ( %+.1f%% ), change %lld sweeps ago\n\n",
+                        sweepCount, ( readNanoseconds() - soakStart ) / 1000000000.0, oldLevel, newLevel,
+                        ( newLevel - oldLevel ) * 100.0 / oldLevel, changeSweeps );
+                outputDouble( "drift", operations[operation], sweepCount, "elapsed_seconds",
+                              ( readNanoseconds() - soakStart ) / 1000000000.0 );
+                outputDouble( "drift", operations[operation], sweepCount, "baseline_mbps", oldLevel );
+                outputDouble( "drift", operations[operation], sweepCount, "level_mbps", newLevel );
+                outputDouble( "drift", operations[operation], sweepCount, "change_percent",
+                              ( newLevel - oldLevel ) * 100.0 / oldLevel );
+                outputInteger( "drift", operations[operation], sweepCount, "change_sweeps", changeSweeps );
+                }
+            sweepBytes = 0.0;
+            sweepTime = 0.0;
+            }
+        if ( ( readNanoseconds() - summaryStart ) >= interval * 1000000000ULL )
+            {
+            soakSummaries++;
+            printSoakSummary( &soakTotal, &soakPart, &soakDrift,
+                              ( readNanoseconds() - soakStart ) / 1000000000.0, soakSummaries );
+            streamClear( &soakPart );
+            summaryStart = readNanoseconds();
+            }
+        // zone read again from start until duration expired
+        if ( ( nextOffset >= stop )&&( ( readNanoseconds() - soakStart ) < duration * 1000000000ULL ) )
+            {
+            nextOffset = start;
+            if ( lseek( fd, start, SEEK_SET ) < 0 )
+                {
+                printf( "%s ( %s )\n", "SEEK ERROR", strerror(errno) );
+                exit(1);
+                }
+            }
+        }
     }
 
 printf( "---------------------------------------------------------\n" );
 
+//--- Block device statistics deltas ---
+stopAndPrintDeviceStat();
+
 //--- Release allocated memory ---
 printf ( "\nRelease memory...\n" );
 free( diskData );
+free( passArray );
 
 //--- Calculate and print benchmarks statistics: min, max, average, median ---
 printf ( "\nBenchmarks statistics (MBPS):\n" );
+
+//--- Soak mode totals by streaming statistics ---
+if ( duration > 0 )
+    {
+    printSoakSummary( &soakTotal, &soakPart, &soakDrift,
+                      ( readNanoseconds() - soakStart ) / 1000000000.0, 0 );
+    printf ( "\nApplication statistics:\n" );
+    printStatistics();
+    exit(0);
+    }
 double statSum = 0.0;
 double statAverage = 0.0;
 double statMedian = 0.0;
@@ -1009,6 +1888,10 @@ else
 //--- Output benchmarks statistics ---
 printf( "Median=%.2f , Average=%.2f , Min=%.2f , Max=%.2f\n" ,
         statMedian, statAverage , statMin , statMax );
+outputDouble( "statistics", operations[operation], 0, "median", statMedian );
+outputDouble( "statistics", operations[operation], 0, "average", statAverage );
+outputDouble( "statistics", operations[operation], 0, "minimum", statMin );
+outputDouble( "statistics", operations[operation], 0, "maximum", statMax );
 
 //--- Print application statistics by OS info ---
 printf ( "\nApplication statistics:\n" );
@@ -3,11 +3,17 @@
 ------------------------------------------------------------------------------
  Linux file operations benchmark.
  This version with extra debug messages.
- Usage:  sudo ./filebench x1 x2 x3
+ Usage:  sudo ./filebench x1 x2 x3 [x4]
  x1 = path and first file name, create, write, and source for copy
  x2 = path and second file name, destination for copy
  x3 = number of sectors
+ x4 = optional results format: output=text, output=json, output=csv,
+      json and csv = start conditions, write/read/copy samples, device
+      statistics and resource usage as records of one schema:
+      section, scenario, benchmark, operation, pass, name, value,
+      records at stdout, console text moved to stderr
  Example:  sudo ./filebench myfile1.bin myfile2.bin 1000
+ Example:  sudo ./filebench myfile1.bin myfile2.bin 1000 output=json
 ------------------------------------------------------------------------------
 
  FileBench3 supports compiling by makefile without NetBeans IDE.
@@ -47,6 +53,7 @@
 //---------- Definitions -------------------------------------------------------
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 #include <malloc.h>
 #include <string.h>
 #include <errno.h>
@@ -57,6 +64,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <sys/sysmacros.h>
 #include <linux/hdreg.h>
 #include <linux/fs.h>
 #include <cctype>
@@ -69,6 +77,15 @@
 #define SLEEP_READ  40        // pause from Write to Read, seconds
 #define SLEEP_COPY  40        // pause from Read to Copy, seconds
 
+#define DEVSTAT_FIELDS 11     // used fields of block device stat file
+#define DEVSTAT_PATH 64       // length of /sys/dev/block/major:minor/stat
+
+#define OUTPUT_TEXT 0         // console text only
+#define OUTPUT_JSON 1         // JSON records at stdout, console text at stderr
+#define OUTPUT_CSV  2         // CSV records at stdout, console text at stderr
+#define OUTPUT_SCHEMA 2       // records schema version, same as mapfile
+#define OUTPUT_NAME 64        // maximum length of record name and value
+
 using namespace std;
 
 //---------- Title message strings ---------------------------------------------
@@ -120,6 +137,8 @@ static const char msgPrintStatistics[] =
     "Linux application statistics:";
 static const char msgSleep[] =
     "Sleep";
+static const char msgDevice[] =
+    "Block device statistics";
 static const char msgDone[] =
     "Done.";
 
@@ -129,7 +148,7 @@ static const char msgError[] =
 static const char msgNumParms[] =
     "wrong number of parameters.";
 static const char msgUsage[] = 
-    "USAGE:   sudo ./filebench filename1 filename2 sectorscount";
+    "USAGE:   sudo ./filebench filename1 filename2 sectorscount [output=text|json|csv]";
 static const char msgExample[] = 
     "EXAMPLE: sudo ./filebench myfile1.bin myfile2.bin 1000";
 static const char msgParm[] = 
@@ -172,6 +191,12 @@ static char nameT2[] = "CLOCK_PROCESS_CPUTIME_ID";
 static char nameT3[] = "CLOCK_THREAD_CPUTIME_ID ";
 static char* namesT[] = { nameT0, nameT1, nameT2, nameT3 };
 
+//---------- Machine readable output, records stream is original stdout --------
+static const char* outputModes[] = { "output=text", "output=json", "output=csv" };
+static int outputMode = OUTPUT_TEXT;   // results format
+static FILE* machineFile = NULL;       // records stream, NULL if text output
+static int machineRecords = 0;         // number of records, for JSON separators
+
 //---------- Helpers functions declaration -------------------------------------
 // called at start of measured interval
 void timerStart ( struct timespec[] , struct timespec[] );
@@ -185,6 +210,27 @@ void benchmarksCalculation
       struct timespec ts1[] , struct timespec ts2[] );
 // get and print Linux application statistics
 void printStatistics();
+// resolve block device stat file of file by st_dev, sysfs
+int resolveDeviceStat( int fd, char statPath[] );
+// read block device stat file, fields of all device IO
+int readDeviceStat( const char statPath[], unsigned long long values[] );
+// print block device statistics deltas, write amplification by logical bytes
+void printDeviceStat( const char statPath[],
+                      unsigned long long start[], unsigned long long stop[],
+                      unsigned long bytes, const char operation[] );
+// open records stream, console text moved to stderr, returns 0 if OK
+int outputOpen();
+// close records stream, called at exit
+void outputClose();
+// write one record: section, scenario, benchmark, operation, pass, name, value
+void outputRecord( const char section[], const char operation[], int pass,
+                   const char name[], const char value[], int quoted );
+// write record with floating point value, not finite values as null
+void outputDouble( const char section[], const char operation[], int pass,
+                   const char name[], double value );
+// write record with integer value
+void outputInteger( const char section[], const char operation[], int pass,
+                    const char name[], long long value );
 
 //---------- Application entry point -------------------------------------------
 int main(int argc, char** argv)    // argc = number of command line arguments, 
@@ -218,6 +264,31 @@ int main(int argc, char** argv)    // argc = number of command line arguments,
     // pauses support
     unsigned int sleepValue = 0;           // input for sleep function
     unsigned int sleepResult = 0;          // special status for sleep function
+    // block devices statistics support
+    char devPath1[DEVSTAT_PATH];           // stat file of first file device
+    char devPath2[DEVSTAT_PATH];           // stat file of second file device
+    unsigned long long dev1[DEVSTAT_FIELDS], dev1x[DEVSTAT_FIELDS];
+    unsigned long long dev2[DEVSTAT_FIELDS], dev2x[DEVSTAT_FIELDS];
+
+//---------- Optional results format, before any console output ---------------
+    if ( argc==5 )
+        {
+        outputMode = -1;
+        for ( i=0; i<3; i++ )
+            {
+            if ( strcmp( argv[4], outputModes[i] ) == 0 ) { outputMode = i; }
+            }
+        if ( outputMode < 0 )
+            {
+            printf ( "\n%s%s\n%s\n%s\n",
+                     msgError, msgParm, msgUsage, msgExample );
+            exit(1);
+            }
+        if ( outputOpen() != 0 )
+            {
+            exit(1);
+            }
+        }
 
 //---------- Console output first title message --------------------------------    
     printf("\n%s\n%s\n", msgRun, msgAbout);
@@ -229,7 +300,7 @@ int main(int argc, char** argv)    // argc = number of command line arguments,
         {
         printf( "\nargv[%d] = %s" , i , argv[i] );
         }
-    if (argc!=4)  // check number of command line arguments
+    if ( ( argc!=4 )&&( argc!=5 ) )  // check number of command line arguments
         {
         printf ( "\n%s%s\n%s\n%s\n",
                  msgError, msgNumParms, msgUsage, msgExample );
@@ -258,6 +329,11 @@ int main(int argc, char** argv)    // argc = number of command line arguments,
             msgReqSecondFile , secondFile ,
             msgReqCount      , sectorsCount ,
             msgReqSize       , sizeMB );
+    outputRecord( "condition", NULL, 0, "first_file", firstFile, 1 );
+    outputRecord( "condition", NULL, 0, "second_file", secondFile, 1 );
+    outputInteger( "condition", NULL, 0, "sectors_count", sectorsCount );
+    outputInteger( "condition", NULL, 0, "file_size", bytesCount );
+    outputInteger( "condition", NULL, 0, "bytes_per_io", SECTORS_PER_IO * SECTOR );
     
 //---------- Create both files, this operations outside of measured time -------
     printf( "\n%s\n", msgCreateFiles );
@@ -274,6 +350,10 @@ int main(int argc, char** argv)    // argc = number of command line arguments,
         exit(1);
         }
 
+//---------- Resolve block devices backing files, for IO statistics ------------
+    resolveDeviceStat( fd1, devPath1 );
+    resolveDeviceStat( fd2, devPath2 );
+
 //---------- Get system timers parameters, console output timers info ----------
     printf( "\n%s\n", msgTimersList );
     for ( i=0; i<TCNT; i++ )
@@ -335,6 +415,7 @@ int main(int argc, char** argv)    // argc = number of command line arguments,
     ssize_t tmptotal = bytesCount;
     ssize_t tmprequest = bytesPerIO;
     // Get time point for operation start, console output checkpoint
+    readDeviceStat( devPath1, dev1 );
     printf( "%s", msgTimerStart );
     timerStart( ts, ts1 );
     // Target operation, write first file (for copy, this file is source)
@@ -363,6 +444,7 @@ int main(int argc, char** argv)    // argc = number of command line arguments,
     // Get time point for operation start, console output checkpoint
     printf( "%s", msgTimerStop );
     timerStop( ts1, ts2 );
+    readDeviceStat( devPath1, dev1x );
     // Calculate results, console output, exit
     printf( "\n%s ", msgCalculate );
     benchmarksCalculation( bytesCount , 
@@ -371,6 +453,10 @@ int main(int argc, char** argv)    // argc = number of command line arguments,
                            ts1 , ts2 );
     printf( "\n%.3lf %s" , mbps, msgMBPS );
     printf( "\n%.3lf %s\n" , timeRatio, msgUtilization );
+    outputDouble( "pass", "write", 1, "mbps", mbps );
+    outputDouble( "pass", "write", 1, "seconds", timeTotal );
+    outputDouble( "pass", "write", 1, "utilization", timeRatio );
+    printDeviceStat( devPath1, dev1, dev1x, bytesCount, "write" );
 
 //---------- Delay before Read -------------------------------------------------
     sleepValue = SLEEP_READ;
@@ -388,6 +474,7 @@ int main(int argc, char** argv)    // argc = number of command line arguments,
     tmptotal = bytesCount;
     tmprequest = bytesPerIO;
     // Get time point for operation start, console output checkpoint
+    readDeviceStat( devPath1, dev1 );
     printf( "%s\n", msgTimerStart );
     timerStart( ts, ts1 );
     // Target operation, write first file (for copy, this file is source)
@@ -422,6 +509,7 @@ int main(int argc, char** argv)    // argc = number of command line arguments,
     // Get time point for operation start, console output checkpoint
     printf( "%s\n", msgTimerStop );
     timerStop( ts1, ts2 );
+    readDeviceStat( devPath1, dev1x );
     // Calculate results, console output, exit
     printf( "%s ", msgCalculate );
     benchmarksCalculation( bytesCount , 
@@ -430,6 +518,10 @@ int main(int argc, char** argv)    // argc = number of command line arguments,
                            ts1 , ts2 );
     printf( "\n%.3lf %s" , mbps, msgMBPS );
     printf( "\n%.3lf %s\n" , timeRatio, msgUtilization );
+    outputDouble( "pass", "read", 1, "mbps", mbps );
+    outputDouble( "pass", "read", 1, "seconds", timeTotal );
+    outputDouble( "pass", "read", 1, "utilization", timeRatio );
+    printDeviceStat( devPath1, dev1, dev1x, bytesCount, "read" );
 
 //---------- Delay before Copy -------------------------------------------------
     sleepValue = SLEEP_COPY;
@@ -447,6 +539,8 @@ int main(int argc, char** argv)    // argc = number of command line arguments,
     tmptotal = bytesCount;
     tmprequest = bytesPerIO;
     // Get time point for operation start, console output checkpoint
+    readDeviceStat( devPath1, dev1 );
+    readDeviceStat( devPath2, dev2 );
     printf( "%s\n", msgTimerStart );
     timerStart( ts, ts1 );
     // Target operation, write first file (for copy, this file is source)
@@ -481,6 +575,8 @@ int main(int argc, char** argv)    // argc = number of command line arguments,
     // Get time point for operation start, console output checkpoint
     printf( "%s\n", msgTimerStop );
     timerStop( ts1, ts2 );
+    readDeviceStat( devPath1, dev1x );
+    readDeviceStat( devPath2, dev2x );
     // Calculate results, console output, exit
     printf( "%s ", msgCalculate );
     benchmarksCalculation( bytesCount , 
@@ -489,6 +585,14 @@ int main(int argc, char** argv)    // argc = number of command line arguments,
                            ts1 , ts2 );
     printf( "\n%.3lf %s" , mbps, msgMBPS );
     printf( "\n%.3lf %s\n" , timeRatio, msgUtilization );
+    outputDouble( "pass", "copy", 1, "mbps", mbps );
+    outputDouble( "pass", "copy", 1, "seconds", timeTotal );
+    outputDouble( "pass", "copy", 1, "utilization", timeRatio );
+    printDeviceStat( devPath1, dev1, dev1x, bytesCount, "copy" );
+    if ( strcmp( devPath1, devPath2 ) != 0 )
+        {
+        printDeviceStat( devPath2, dev2, dev2x, bytesCount, "copy_destination" );
+        }
 
 //---------- Delete both files -------------------------------------------------    
     printf( "\n%s\n", msgDeleteFiles );
@@ -624,5 +728,215 @@ void printStatistics()
     printf ( "\nSignals received                 = %ld", usage.ru_nsignals );
     printf ( "\nVoluntary context switches       = %ld", usage.ru_nvcsw );
     printf ( "\nInvoluntary context switches     = %ld\n", usage.ru_nivcsw );
+    outputInteger( "rusage", NULL, 0, "utime_us",
+                   (long long)usage.ru_utime.tv_sec * 1000000 + usage.ru_utime.tv_usec );
+    outputInteger( "rusage", NULL, 0, "stime_us",
+                   (long long)usage.ru_stime.tv_sec * 1000000 + usage.ru_stime.tv_usec );
+    outputInteger( "rusage", NULL, 0, "maxrss_kb", usage.ru_maxrss );
+    outputInteger( "rusage", NULL, 0, "minflt", usage.ru_minflt );
+    outputInteger( "rusage", NULL, 0, "majflt", usage.ru_majflt );
+    outputInteger( "rusage", NULL, 0, "nswap", usage.ru_nswap );
+    outputInteger( "rusage", NULL, 0, "inblock", usage.ru_inblock );
+    outputInteger( "rusage", NULL, 0, "oublock", usage.ru_oublock );
+    outputInteger( "rusage", NULL, 0, "nsignals", usage.ru_nsignals );
+    outputInteger( "rusage", NULL, 0, "nvcsw", usage.ru_nvcsw );
+    outputInteger( "rusage", NULL, 0, "nivcsw", usage.ru_nivcsw );
     return;
 }
+
+// resolve block device stat file of file by st_dev, sysfs
+// returns 0 if resolved, -1 if file system without block device (tmpfs)
+int resolveDeviceStat( int fd, char statPath[] )
+    {
+    struct stat info;
+    statPath[0] = 0;
+    if ( fstat( fd, &info ) != 0 )
+        {
+        return -1;
+        }
+    snprintf( statPath, DEVSTAT_PATH, "/sys/dev/block/%u:%u/stat",
+              major( info.st_dev ), minor( info.st_dev ) );
+    if ( access( statPath, R_OK ) != 0 )
+        {
+        statPath[0] = 0;
+        return -1;
+        }
+    return 0;
+    }
+
+// read block device stat file, fields of all device IO
+// returns 0 if OK, -1 if not available
+int readDeviceStat( const char statPath[], unsigned long long values[] )
+    {
+    FILE* statFile = NULL;
+    int i = 0, count = 0;
+    for ( i=0; i<DEVSTAT_FIELDS; i++ )
+        {
+        values[i] = 0;
+        }
+    if ( statPath[0] == 0 )
+        {
+        return -1;
+        }
+    statFile = fopen( statPath, "r" );
+    if ( statFile == NULL )
+        {
+        return -1;
+        }
+    for ( i=0; i<DEVSTAT_FIELDS; i++ )
+        {
+        count += fscanf( statFile, "%llu", &values[i] );
+        }
+    fclose( statFile );
+    return ( count == DEVSTAT_FIELDS ) ? 0 : -1;
+    }
+
+// print block device statistics deltas, write amplification by logical bytes
+// stat file fields: 0=read IOs, 2=read sectors, 3=read ms, 4=write IOs,
+// 6=write sectors, 7=write ms, 10=time in queue ms, sectors are 512 bytes
+void printDeviceStat( const char statPath[],
+                      unsigned long long start[], unsigned long long stop[],
+                      unsigned long bytes, const char operation[] )
+    {
+    long long d[DEVSTAT_FIELDS];
+    long long ios = 0;
+    int i = 0;
+    if ( statPath[0] == 0 )
+        {
+        printf( "%s: n/a, no block device\n", msgDevice );
+        return;
+        }
+    for ( i=0; i<DEVSTAT_FIELDS; i++ )
+        {
+        d[i] = stop[i] - start[i];
+        }
+    ios = d[0] + d[4];
+    printf( "%s %s:\n", msgDevice, statPath );
+    printf( "read %lld IOs %.0f KB avg %.1f KB, write %lld IOs %.0f KB avg %.1f KB\n",
+            d[0], d[2] * 512 / 1024.0, d[0] > 0 ? d[2] * 512 / 1024.0 / d[0] : 0.0,
+            d[4], d[6] * 512 / 1024.0, d[4] > 0 ? d[6] * 512 / 1024.0 / d[4] : 0.0 );
+    printf( "queue %lld ms, wait %.3f ms per IO, write amplification %.3f\n",
+            d[10], ios > 0 ? (double)( d[3] + d[7] ) / ios : 0.0,
+            bytes > 0 ? d[6] * 512.0 / bytes : 0.0 );
+    outputInteger( "pass", operation, 1, "dev_read_ios", d[0] );
+    outputInteger( "pass", operation, 1, "dev_read_bytes", d[2] * 512 );
+    outputInteger( "pass", operation, 1, "dev_write_ios", d[4] );
+    outputInteger( "pass", operation, 1, "dev_write_bytes", d[6] * 512 );
+    outputInteger( "pass", operation, 1, "dev_queue_ms", d[10] );
+    }
+
+// open records stream, records written to original stdout,
+// console text moved to stderr, stream closed at exit,
+// so JSON document valid if run stopped by error, returns 0 if OK
+int outputOpen()
+    {
+    int handle = 0;
+    if ( outputMode == OUTPUT_TEXT )
+        {
+        return 0;
+        }
+    fflush( stdout );
+    handle = dup( STDOUT_FILENO );
+    if ( ( handle < 0 )||( dup2( STDERR_FILENO, STDOUT_FILENO ) < 0 )||
+         ( ( machineFile = fdopen( handle, "w" ) ) == NULL ) )
+        {
+        printf( "\n%soutput redirection failed ( %s )\n", msgError, strerror(errno) );
+        return -1;
+        }
+    if ( outputMode == OUTPUT_JSON )
+        {
+        fprintf( machineFile, "{\"tool\":\"filebench\",\"version\":\"0.45\",\"schema\":%d,\"records\":[",
+                 OUTPUT_SCHEMA );
+        }
+    else
+        {
+        fprintf( machineFile, "section,scenario,benchmark,operation,pass,name,value\n" );
+        }
+    atexit( outputClose );
+    return 0;
+    }
+
+// close records stream, called at exit
+void outputClose()
+    {
+    if ( machineFile == NULL )
+        {
+        return;
+        }
+    fflush( stdout );
+    if ( outputMode == OUTPUT_JSON )
+        {
+        fprintf( machineFile, "\n]}\n" );
+        }
+    fclose( machineFile );
+    machineFile = NULL;
+    }
+
+// write one record: section, scenario, benchmark, operation, pass, name, value,
+// scenario is 0 (no test plan), one benchmark is 1,
+// start conditions and resource usage are benchmark 0,
+// operation NULL and pass 0 means not applicable
+void outputRecord( const char section[], const char operation[], int pass,
+                   const char name[], const char value[], int quoted )
+    {
+    const char* p = NULL;
+    int benchmark = ( strcmp( section, "pass" ) == 0 )||( strcmp( section, "statistics" ) == 0 );
+    if ( machineFile == NULL )
+        {
+        return;
+        }
+    if ( outputMode == OUTPUT_JSON )
+        {
+        fprintf( machineFile, "%s\n{\"section\":\"%s\",\"scenario\":0,\"benchmark\":%d,",
+                 machineRecords ? "," : "", section, benchmark );
+        if ( operation != NULL ) { fprintf( machineFile, "\"operation\":\"%s\",", operation ); }
+        else { fprintf( machineFile, "\"operation\":null," ); }
+        if ( pass > 0 ) { fprintf( machineFile, "\"pass\":%d,", pass ); }
+        else { fprintf( machineFile, "\"pass\":null," ); }
+        fprintf( machineFile, "\"name\":\"%s\",\"value\":%s", name, quoted ? "\"" : "" );
+        for ( p=value; *p!=0; p++ )
+            {
+            if ( quoted && ( ( *p == '"' )||( *p == '\\' ) ) ) { fputc( '\\', machineFile ); }
+            if ( (unsigned char)*p >= ' ' ) { fputc( *p, machineFile ); }
+            }
+        fprintf( machineFile, "%s}", quoted ? "\"" : "" );
+        }
+    else
+        {
+        fprintf( machineFile, "%s,0,%d,%s,", section, benchmark, operation != NULL ? operation : "" );
+        if ( pass > 0 ) { fprintf( machineFile, "%d", pass ); }
+        fprintf( machineFile, ",%s,%s", name, quoted ? "\"" : "" );
+        for ( p=value; *p!=0; p++ )
+            {
+            if ( quoted && ( *p == '"' ) ) { fputc( '"', machineFile ); }
+            fputc( *p, machineFile );
+            }
+        fprintf( machineFile, "%s\n", quoted ? "\"" : "" );
+        }
+    machineRecords++;
+    }
+
+// write record with floating point value, not finite values as null
+void outputDouble( const char section[], const char operation[], int pass,
+                   const char name[], double value )
+    {
+    char text[OUTPUT_NAME];
+    if ( isfinite( value ) )
+        {
+        snprintf( text, OUTPUT_NAME, "%.9g", value );
+        }
+    else
+        {
+        snprintf( text, OUTPUT_NAME, "%s", outputMode == OUTPUT_JSON ? "null" : "" );
+        }
+    outputRecord( section, operation, pass, name, text, 0 );
+    }
+
+// write record with integer value
+void outputInteger( const char section[], const char operation[], int pass,
+                    const char name[], long long value )
+    {
+    char text[OUTPUT_NAME];
+    snprintf( text, OUTPUT_NAME, "%lld", value );
+    outputRecord( section, operation, pass, name, text, 0 );
+    }
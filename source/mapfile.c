@@ -11,44 +11,189 @@ sudo ./mapfile [options]
 options list:
 
 path=<file path>  , target file path and name, default myfile.bin in the current directory
-size=<block size> , default 1GB, default units=bytes (possible K/M/G), examples: 10240, 16K, 20M, 1G
-wsync=<0|1>       , don't synchronize write(0), synchronize(1), default=synchronize(1)
+size=<block size> , default 1GB, default units=bytes (possible K/M/G/T), examples: 10240, 16K, 20M, 1G, 500G
+wsync=<mode>      , write flush primitive after write walk, flush timed separately, default fsync
+                    none, fsync, fdatasync, msync (MS_SYNC), msync_async (MS_ASYNC),
+                    sfr = sync_file_range() start write-out, sfr_wait = start and wait after,
+                    sfr_waitall = wait before, start and wait after; 0 and 1 same as none and fsync
 wdelay=<value>    , delay from start to write, milliseconds
 rdelay=<value>    , delay from write end to read, milliseconds
-repeats=<value>   , number of times to repeat test, for measurement
+repeats=<value>   , number of times to repeat test, for measurement, no fixed limit, logs allocated by repeats
+                    statistics: median, average, minimum, maximum, stddev, CV %, P5, P95,
+                    95% confidence interval of median by bootstrap (fixed seed, reproducible)
+outliers=<value>  , outliers rejection, samples beyond value * 1.4826 * MAD from median rejected
+                    before statistics, rejected count reported, default 0 = not used
+precision=<value> , adaptive repeats, passes run until width of median 95% confidence interval
+                    is not above value percents of median, decimal point allowed, default 0 = fixed repeats,
+                    repeats = minimum passes after warm-up, warm-up passes detected by MSER rule and discarded
+maxrepeats=<value>, adaptive repeats, maximum passes per operation, default 100
+budget=<value>    , adaptive repeats, wall clock limit per operation (write passes, read passes), seconds,
+                    default 0 = not limited
+duration=<value>  , soak mode, write pass and read pass in turn until duration expired, seconds,
+                    default 0 = not used, constant memory: Welford mean and variance, P-square P5, median, P95,
+                    drift = sustained change of throughput, two-sided CUSUM against baseline of 20 passes
+interval=<value>  , soak mode, periodic summary interval, seconds, default 60
+threads=<value>   , number of page walk threads, each pinned to own CPU, default 1
+pages=<mode>      , page size used by mapping: 4k, thp, hugetlb, default 4k
+                    4k = default mapping, one walk step per 4KB page
+                    thp = transparent huge pages requested by madvise(MADV_HUGEPAGE),
+                          use tmpfs mounted with huge= option for shmem huge pages,
+                          walk step is base page, THP backing not known before fault
+                    hugetlb = file at hugetlbfs mount, mapping with MAP_HUGETLB
+advice=<mode>     , access pattern hint applied after mapping, before timed walk, default none
+                    madvise(): normal, sequential, random, willneed
+                    posix_fadvise(): fnormal, fsequential, frandom, fwillneed
+                    all = run for each hint, results side by side
+populate=<mode>   , prefault mapping before timed walk, prefault timed separately, default none
+                    map_populate, madv_populate_read, madv_populate_write, mlock
+addressing=<mode> , page walk order: sequential, reverse, random, strided, default sequential
+                    random and strided are full coverage permutations, each page visited once
+seed=<value>      , seed for random addressing, default 1
+kernel=<mode>     , page walk kernel, default touch
+                    touch = one byte per page, fault cost only
+                    memset = memset() write, scalar 64-bit loads read, all bytes of page
+                    memcpy = memcpy() from/to per-thread buffer, all bytes of page
+                    sse2, avx2, avx512 = SIMD stores/loads, all cache lines of page
+                    nt = non-temporal stores, streaming loads (SSE4.1)
+                    auto = best SIMD kernel supported by CPU, by CPUID
+stride=<size>     , page walk step, from 64 bytes to 16M, multiple of 64, default page size
+                    touch kernel with stride above page: MBPS counts touched pages only
+sweep=<mode>      , benchmark for geometric series, results table, default none
+                    stride = strides from 64 bytes up to 16M
+                    size = file sizes from 4K up to ramfactor * physical RAM, knee marked
+                    window = window sizes from page size up to file size, mmap/munmap cost
+ramfactor=<value> , size sweep limit as multiple of physical RAM, default 2
+window=<size>     , map, walk and unmap file by windows of this size in turn, default 0 = whole file
+                    required for files above mapping limit (1.5G for 32-bit build)
+overlap=<size>    , overlap of adjacent windows, window moves by window minus overlap, default 0
+                    MBPS counts overlapped bytes walked again
+prepare=<mode>    , test file preparation, default each
+                    each = file created and written before each pass, deleted after it
+                    once = file created and written once, threads>1 write in parallel, reused by passes
+                    fallocate = file allocated once by fallocate(), not written, reused by passes
+                    sparse = file size set once by ftruncate(), no blocks allocated, reused by passes
+                    reused file flushed and evicted from page cache before each pass
+cache=<mode>      , page cache state of file before each timed read walk, default cold
+                    cold = written back and evicted by posix_fadvise(DONTNEED)
+                    drop = cold and /proc/sys/vm/drop_caches, privileged runs only
+                    warm = cold and file pre-read by read(), pages cached but not mapped
+                    hot = warm and mapping pre-touched, pages cached and mapped, if window not used
+                    resident part of file checked by mincore() before each timed walk
+counters=<value>  , performance counters by perf_event_open(), 1 = used, default 0 = not used
+                    cycles, instructions, dTLB-load-misses, page-faults, major-faults, context-switches
+                    around write walk, flush and read walk, per pass deltas, cycles/page, TLB misses/GiB
+                    user space only if kernel counting not permitted, n/a if counter not available
+kstat=<value>     , kernel counters deltas, 1 = used, default 0 = not used, snapshots before and after
+                    write walk, flush and read walk: /proc/vmstat faults, paging, dirty, writeback, reclaim scan
+                    and steal, THP, /proc/self/io bytes, /proc/pressure io and memory stall time, microseconds
+devstat=<value>   , block device statistics, 1 = used, default 0 = not used, device backing target file
+                    resolved by st_dev and /sys/dev/block, stat file read before and after write walk,
+                    flush and read walk: IOs, bytes, average request size, queue time, wait per IO,
+                    write amplification = device written bytes / file size
+output=<mode>     , results format at stdout: text, json, csv, default text
+                    json and csv = machine readable records, console text moved to stderr,
+                    one schema for both: section, scenario, benchmark, operation, pass, name, value
+                    sections: condition (start conditions), scenario (test plan scenario),
+                    benchmark (sweep or advice point), pass (per pass samples),
+                    statistics (median, average, minimum, maximum, distribution), rusage
+plan=<file>       , test plan, scenarios run back to back without prompt, one results set,
+                    NAME=VALUE options same as command line, separated by spaces or lines, # comment,
+                    scenario=<name> starts scenario, options before first scenario used by all,
+                    comma separated values run as cartesian product, example threads=1,2,4 size=1G,4G,
+                    command line options are defaults, restored before each scenario
+timer=<mode>      , time source for all measurements, default auto
+                    tsc = invariant TSC calibrated against CLOCK_MONOTONIC_RAW, x86 only
+                    monotonic = clock_gettime(CLOCK_MONOTONIC)
+                    auto = tsc if invariant TSC reported by CPUID, otherwise monotonic
+                    timer read overhead and resolution measured at start, overhead subtracted from page latencies
+latency=<value>   , page latency histogram, every N-th walk step timed, default 0 = not used
+                    1 = each page timed, p50/p90/p99/p99.9/max per pass and for all passes
+writebehind=<size>, write-behind chunk, flusher thread starts write-out of chunks already dirtied
+                    by walk, msync() for msync modes, otherwise sync_file_range(), default 0 = not used,
+                    single thread sequential walk, page write stalls distribution reported
+rwmix=<value>     , mixed walk, percent of reads, writes and reads interleaved on same MAP_SHARED mapping
+                    by all threads, default -1 = not used (write passes, then read passes),
+                    every access timed, write and read MBPS and latencies reported separately
+distribution=<mode>, mixed walk pages access distribution, default uniform
+                    uniform = all pages equal
+                    zipf = Zipf with theta = skew/100, hot pages spread over file
+                    hotspot = skew % of accesses to (100-skew) % of pages
+skew=<value>      , mixed walk distribution skew, percents 1-99, default 80
 
 examples (default and custom)
 
 sudo ./mapfile
 sudo ./mapfile path=aaa.bin size=100K wsync=0 wdelay=1000 rdelay=3000 repeats=3
+sudo ./mapfile size=1G threads=4
+sudo ./mapfile path=/mnt/huge/aaa.bin size=1G pages=hugetlb
+sudo ./mapfile size=512M repeats=3 advice=all
+sudo ./mapfile size=1G populate=madv_populate_read
+sudo ./mapfile size=1G addressing=random seed=5
+sudo ./mapfile size=1G kernel=auto
+sudo ./mapfile size=1G repeats=3 sweep=stride
+sudo ./mapfile repeats=3 sweep=size ramfactor=2
+sudo ./mapfile size=200G window=1G repeats=1
+sudo ./mapfile size=1G window=64M overlap=4M
+sudo ./mapfile size=1G repeats=3 sweep=window
+sudo ./mapfile size=1G wsync=fdatasync writebehind=8M
+sudo ./mapfile size=16G repeats=10 prepare=once threads=4
+sudo ./mapfile size=1G cache=warm
+sudo ./mapfile size=1G latency=1 addressing=random
+sudo ./mapfile size=1G latency=1 timer=monotonic
+sudo ./mapfile size=1G counters=1 addressing=random
+sudo ./mapfile size=8G window=1G kstat=1 wsync=fdatasync
+sudo ./mapfile size=4G devstat=1 writebehind=16M wsync=sfr_wait
+sudo ./mapfile size=1G repeats=10 output=json < yes.txt > results.json
+sudo ./mapfile plan=capacity.plan output=csv > results.csv
+sudo ./mapfile size=256M repeats=50 outliers=3
+sudo ./mapfile size=1G repeats=5 precision=1 maxrepeats=200 budget=600
+sudo ./mapfile size=4G duration=14400 interval=300 prepare=once wsync=fdatasync
+sudo ./mapfile size=1G rwmix=70 distribution=zipf skew=99 threads=4
 
 */
 
 #define _GNU_SOURCE
+#define _FILE_OFFSET_BITS 64           // 64-bit off_t for 32-bit build, files above 2GB
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <malloc.h>
 #include <string.h>
 #include <errno.h>
 #include <time.h>
 #include <ctype.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/statfs.h>
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
 #include <linux/hdreg.h>
 #include <linux/fs.h>
+#include <linux/magic.h>
+#include <sys/sysmacros.h>
+#include <limits.h>
+#include <math.h>
+#include <libgen.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#include <cpuid.h>
+#define KERNELS_X86                    // SIMD page walk kernels supported
+#endif
 
 //--- Title string ---
 #ifdef __x86_64__
-#define TITLE "Memory-mapped files benchmark for Linux 64.\n(C)2018 IC Book Labs. v0.08"
+#define TITLE "Memory-mapped files benchmark for Linux 64.\n(C)2018 IC Book Labs. v0.09"
 #else
-#define TITLE "Memory-mapped files benchmark for Linux 32.\n(C)2018 IC Book Labs. v0.08"
+#define TITLE "Memory-mapped files benchmark for Linux 32.\n(C)2018 IC Book Labs. v0.09"
 #endif
 
 //--- Defaults definitions ---
@@ -58,26 +203,228 @@ sudo ./mapfile path=aaa.bin size=100K wsync=0 wdelay=1000 rdelay=3000 repeats=3
 #define WRITE_DELAY 100                // default delay from Start to Write in milliseconds, argument of Sleep()
 #define READ_DELAY  100                // default delay from Write end to Read in milliseconds, argument of Sleep()
 #define MEASURE_REPEATS 5              // default number of measurement repeats
+#define WALK_THREADS 1                 // default number of page walk threads
+#define PAGE_MODE   0                  // default page mode, 4KB pages
+#define ADVICE_MODE 0                  // default access advice, not used
+#define POPULATE_MODE 0                // default prefault mode, not used
+#define ADDRESSING_MODE 0              // default page walk addressing, sequential
+#define WALK_SEED   1                  // default seed for random addressing
+#define KERNEL_MODE 0                  // default page walk kernel, one byte per page
+#define WALK_STRIDE 0                  // default page walk stride, 0 means page size
+#define SWEEP_MODE  0                  // default sweep mode, no sweep
+#define RAM_FACTOR  2                  // default size sweep limit, multiple of physical RAM
+#define WINDOW_SIZE 0                  // default mapping window, 0 means whole file mapped
+#define WINDOW_OVERLAP 0               // default overlap of adjacent windows
+#define WRITE_BEHIND 0                 // default write-behind chunk, 0 means flusher thread not used
+#define PREPARE_MODE 0                 // default file preparation, file created for each pass
+#define CACHE_MODE   0                 // default page cache state before read walk, cold
+#define LATENCY_STEP 0                 // default latency sampling, 0 means latency not measured
+#define TIMER_MODE   0                 // default time source, auto
+#define COUNTERS     0                 // default performance counters, not used
+#define KSTAT        0                 // default kernel counters deltas, not used
+#define DEVSTAT      0                 // default block device statistics, not used
+#define OUTPUT_MODE  0                 // default results format, console text
 
 //--- Limits definitions ---
 #define FILE_SIZE_MIN  4096            // minimum file size 4096 bytes
-#define FILE_SIZE_MAX  1536*1024*1024  // maximum file size 1.5 gigabytes
-#define WSYNC_NO       0               // additional write synchronization don't used
-#define WSYNC_YES      1               // additional write synchronization used
+#define FILE_SIZE_MAX  4LL*1024*1024*1024*1024  // maximum file size 4 terabytes, 64-bit offsets
+#if UINTPTR_MAX > 0xFFFFFFFF
+#define MAP_SIZE_MAX   FILE_SIZE_MAX   // maximum mapping size, 64-bit address space
+#else
+#define MAP_SIZE_MAX   1536*1024*1024  // maximum mapping size 1.5 gigabytes, 32-bit address space
+#endif
 #define DELAY_MIN      0               // minimum delay value, 0 milliseconds
 #define DELAY_MAX      100000          // maximum delay value, 100000 milliseconds = 100 seconds
 #define REPEATS_MIN    0               // minimum number of measurement repeats
-#define REPEATS_MAX    100             // maximum number of measurement repeats
+#define REPEATS_MAX    1000000         // maximum number of measurement repeats, logs allocated dynamically
+#define THREADS_MIN    1               // minimum number of page walk threads
+#define THREADS_MAX    256             // maximum number of page walk threads
 
 //--- Memory allocation constants ---
 #define BUFFER_SIZE 1024*1024          // buffer size for file create only
+#define FILL_CHUNK  256*1024*1024      // mapping chunk for file create by mapping, hugetlbfs only
 #define BUFFER_ALIGNMENT 4096          // alignment factor, 4KB is page size for x86/x64
 
-//--- Timer constant ---
+//--- Timer constants ---
 #define TIME_TO_SECONDS 0.000000001    // multiply by this to convert 1 nanosecond units to 1 second
+#define TIMER_AUTO      0              // invariant TSC if supported, otherwise CLOCK_MONOTONIC
+#define TIMER_TSC       1              // invariant TSC, calibrated against CLOCK_MONOTONIC_RAW
+#define TIMER_MONOTONIC 2              // clock_gettime( CLOCK_MONOTONIC )
+#define TIMER_CALIBRATE 100000000      // TSC calibration interval, nanoseconds
+#define TIMER_PROBES    100000         // number of back-to-back reads for overhead and resolution
 
 //--- Page walk constant ---
-#define PAGE_WALK_STEP 4096            // step for cause swapping, page=4096 bytes but sector=512 bytes
+#define PAGE_WALK_STEP 4096            // page size if not detected by sysconf(), page=4096 bytes but sector=512 bytes
+#define STRIDE_MIN     64              // minimum page walk stride, one cache line
+#define STRIDE_MAX     16*1024*1024    // maximum page walk stride
+#define SWEEP_FACTOR   2               // geometric series factor for sweeps
+#define SWEEP_MAX      64              // maximum number of sweep points
+#define RAM_FACTOR_MIN 1               // minimum size sweep limit, multiple of physical RAM
+#define RAM_FACTOR_MAX 16              // maximum size sweep limit, multiple of physical RAM
+#define KNEE_RATIO     0.5             // knee detected if read speed below this part of previous peak
+#define MEMINFO_PATH   "/proc/meminfo"
+#define STATUS_PATH    "/proc/self/status"
+#define DROP_CACHES_PATH "/proc/sys/vm/drop_caches"
+#define VMSTAT_PATH    "/proc/vmstat"
+#define IO_PATH        "/proc/self/io"
+#define PSI_IO_PATH    "/proc/pressure/io"
+#define PSI_MEMORY_PATH "/proc/pressure/memory"
+#define SYS_BLOCK_PATH "/sys/dev/block" // block devices by major:minor, stat file per device or partition
+#define DEVSTAT_FIELDS 11              // used fields of stat file, up to time_in_queue
+#define SECTOR_BYTES   512             // stat file sector units, independent of device sector size
+#define STALL_THRESHOLD 100000         // page write time above this counted as stall, nanoseconds
+#define LATENCY_STEP_MAX 1000000       // maximum latency sampling, one of N walk steps timed
+
+//--- Latency histogram constants, log-linear: each power of 2 range split to linear sub-buckets ---
+#define LAT_SUB_BITS   4               // 16 linear sub-buckets per power of 2, relative error below 1/16
+#define LAT_SUB        ( 1 << LAT_SUB_BITS )
+#define LAT_MAX_BITS   40              // values up to 2^40 nanoseconds, about 18 minutes
+#define LAT_BUCKETS    ( ( LAT_MAX_BITS - LAT_SUB_BITS + 1 ) * LAT_SUB )
+#define WALK_WRITE     0               // page walk operation: write one byte per page
+#define WALK_READ      1               // page walk operation: read one byte per page
+#define WALK_MIXED     2               // page walk operation: reads and writes interleaved by rwmix
+
+//--- Results format constants ---
+#define OUTPUT_TEXT    0               // console text only
+#define OUTPUT_JSON    1               // JSON records at stdout, console text at stderr
+#define OUTPUT_CSV     2               // CSV records at stdout, console text at stderr
+#define OUTPUT_SCHEMA  2               // records schema version, changed if fields changed
+#define OUTPUT_NAME    64              // maximum length of record name
+
+//--- Results statistics constants ---
+#define OUTLIERS        0              // default outliers rejection limit, 0 = not used
+#define OUTLIERS_MAX    100            // maximum outliers rejection limit, MAD units
+#define STAT_BOOTSTRAP  1000           // number of bootstrap resamples for median confidence interval
+#define STAT_SEED       0x9E3779B97F4A7C15ULL  // bootstrap resampling seed, results reproducible
+#define STAT_MAD_SCALE  1.4826         // MAD to standard deviation scale for normal distribution
+
+//--- Adaptive repeats constants ---
+#define PRECISION       "0"            // default median confidence interval width target, percents, 0 = fixed repeats
+#define PRECISION_MAX   100.0          // maximum confidence interval width target, percents
+#define REPEATS_LIMIT   100            // default maximum number of passes per operation, adaptive repeats
+#define REPEATS_ADAPTIVE 3             // minimum repeats value for adaptive repeats
+#define BUDGET          0              // default wall clock budget per operation, seconds, 0 = not limited
+#define BUDGET_MAX      604800         // maximum wall clock budget per operation, seconds
+#define WARMUP_MIN      4              // minimum number of passes for warm-up detection
+
+//--- Soak mode constants ---
+#define DURATION        0              // default soak duration, seconds, 0 = not used
+#define DURATION_MAX    2592000        // maximum soak duration, seconds, 30 days
+#define INTERVAL        60             // default soak summary interval, seconds
+#define INTERVAL_MAX    86400          // maximum soak summary interval, seconds
+#define DRIFT_BASELINE  20             // passes for drift detection baseline, after start or drift
+#define DRIFT_K         0.5            // CUSUM slack, baseline standard deviations
+#define DRIFT_H         10.0           // CUSUM alarm threshold, baseline standard deviations
+#define DRIFT_SIGMA_MIN 0.01           // minimum baseline standard deviation, part of baseline mean
+
+//--- Mixed read/write walk constants ---
+#define RWMIX           -1             // default reads percentage of mixed walk, -1 = not used
+#define DISTRIBUTION    0              // default mixed walk access distribution, uniform
+#define DIST_UNIFORM    0              // pages with equal probability
+#define DIST_ZIPF       1              // Zipf distribution of pages popularity, theta = skew / 100
+#define DIST_HOTSPOT    2              // skew percents of accesses to ( 100 - skew ) percents of pages
+#define SKEW            80             // default distribution skew, percents
+#define SKEW_MIN        1              // minimum distribution skew, percents
+#define SKEW_MAX        99             // maximum distribution skew, percents
+#define ZIPF_EXACT      10000          // Zipf normalization terms summed exactly, integral approximation for rest
+#define MIX_SCRAMBLE    0x9E3779B1ULL  // popularity rank to page multiplier, adjusted to coprime with pages
+
+//--- Test plan constants ---
+#define PLAN_LINE       1024           // maximum length of plan file line
+#define PLAN_ARG        81             // maximum length of one NAME=VALUE option, same as command line
+#define PLAN_TOKENS     256            // maximum number of options in plan file
+#define PLAN_SCENARIOS  128            // maximum number of named scenarios
+#define PLAN_RUNS       4096           // maximum number of scenario runs, cartesian products expanded
+#define PLAN_OPTIONS    64             // maximum number of command line options, restored for each run
+
+//--- Timed phases constants, for counters deltas ---
+#define PHASE_WRITE    0               // write walk
+#define PHASE_FLUSH    1               // write flush after walk
+#define PHASE_READ     2               // read walk
+#define PHASES         3               // number of timed phases
+
+//--- Performance counters constants ---
+#define PERF_EVENTS    6               // number of counters in group
+#define PERF_CYCLES    0               // index of cycles counter, used for derived metrics
+#define PERF_INSTRUCTIONS 1            // index of instructions counter
+#define PERF_DTLB      2               // index of dTLB load misses counter
+
+//--- Page modes constants ---
+#define PAGES_4K       0               // default mapping, 4KB pages
+#define PAGES_THP      1               // transparent huge pages, madvise(MADV_HUGEPAGE)
+#define PAGES_HUGETLB  2               // hugetlbfs file, mapping with MAP_HUGETLB
+#define HUGE_PAGE_SIZE 2*1024*1024     // THP size if not detected by sysfs
+#define THP_SIZE_PATH  "/sys/kernel/mm/transparent_hugepage/hpage_pmd_size"
+#define SMAPS_PATH     "/proc/self/smaps"
+#define SMAPS_LINE     256             // maximum length of smaps line
+
+//--- File preparation modes constants ---
+#define PREPARE_EACH      0            // file created and written before each pass
+#define PREPARE_ONCE      1            // file created and written once, reused
+#define PREPARE_FALLOCATE 2            // file allocated once by fallocate(), reused
+#define PREPARE_SPARSE    3            // file size set once by ftruncate(), reused
+
+//--- Page cache state modes constants ---
+#define CACHE_COLD        0            // file evicted from page cache
+#define CACHE_DROP        1            // file evicted and all clean page cache dropped
+#define CACHE_WARM        2            // file cached by read(), not mapped
+#define CACHE_HOT         3            // file cached and mapping pre-touched
+
+//--- Write flush primitives constants ---
+#define WSYNC_NONE        0            // additional write synchronization not used
+#define WSYNC_FSYNC       1            // fsync()
+#define WSYNC_FDATASYNC   2            // fdatasync()
+#define WSYNC_MSYNC       3            // msync( MS_SYNC ) of mapping
+#define WSYNC_MSYNC_ASYNC 4            // msync( MS_ASYNC ) of mapping
+#define WSYNC_SFR         5            // sync_file_range(), start write-out only
+#define WSYNC_SFR_WAIT    6            // sync_file_range(), start write-out and wait after
+#define WSYNC_SFR_WAITALL 7            // sync_file_range(), wait before, start write-out and wait after
+
+//--- Access advices constants, madvise() for mapping or posix_fadvise() for file ---
+#define ADVICE_NONE    0               // access advice not used
+#define ADVICE_MADV    1               // first madvise() advice
+#define ADVICE_FADV    5               // first posix_fadvise() advice
+#define ADVICE_ALL     9               // cycle for all advices, results side by side
+
+//--- Page walk addressing modes constants ---
+#define ADDR_SEQUENTIAL 0              // pages forward, one by one
+#define ADDR_REVERSE    1              // pages backward, one by one
+#define ADDR_RANDOM     2              // seeded pseudo-random permutation of pages
+#define ADDR_STRIDED    3              // pages by stride, stride coprime with number of pages
+#define STRIDED_PAGES   17             // minimal stride for strided addressing, pages
+
+//--- Page walk kernels constants ---
+#define KERNEL_TOUCH    0              // one byte per page, fault cost only
+#define KERNEL_MEMSET   1              // write by memset(), read by compiler-generated loop
+#define KERNEL_MEMCPY   2              // memcpy() from/to per-thread buffer
+#define KERNEL_SSE2     3              // 128-bit loads/stores
+#define KERNEL_AVX2     4              // 256-bit loads/stores
+#define KERNEL_AVX512   5              // 512-bit loads/stores
+#define KERNEL_NT       6              // non-temporal stores, streaming loads
+#define KERNEL_AUTO     7              // best SIMD kernel by CPUID
+#define CACHE_LINE      64             // kernels unrolled by cache line
+
+//--- Sweep modes constants ---
+#define SWEEP_NONE      0              // single benchmark
+#define SWEEP_STRIDE    1              // benchmark for geometric series of strides
+#define SWEEP_SIZE      2              // benchmark for geometric series of file sizes
+#define SWEEP_WINDOW    3              // benchmark for geometric series of mapping windows
+
+//--- Prefault modes constants ---
+#define POPULATE_NONE  0               // no prefault, pages faulted by timed walk
+#define POPULATE_MAP   1               // mmap() with MAP_POPULATE
+#define POPULATE_READ  2               // madvise(MADV_POPULATE_READ)
+#define POPULATE_WRITE 3               // madvise(MADV_POPULATE_WRITE)
+#define POPULATE_MLOCK 4               // mlock() of mapping
+#ifndef MADV_POPULATE_READ
+#define MADV_POPULATE_READ  22         // Linux 5.14 and above
+#endif
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23         // Linux 5.14 and above
+#endif
+#ifndef HUGETLBFS_MAGIC
+#define HUGETLBFS_MAGIC 0x958458f6
+#endif
 
 //--- Output tabulation options ---
 #define IPB_TABS  18    // number of chars before "=" for tabulation, this used for start conditions (input parameters block)
@@ -86,15 +433,89 @@ sudo ./mapfile path=aaa.bin size=100K wsync=0 wdelay=1000 rdelay=3000 repeats=3
 //--- Numeric data for storing command line options, with defaults assigned ---
 static char    fileDefaultPath[] = FILE_PATH;   // constant string for references
 static char*   filePath   = fileDefaultPath;    // pointer to file path string
-static size_t  fileSize   = FILE_SIZE;          // file size, bytes
-static int     wsyncMode  = WSYNC_YES;          // additional write synchronization option
+static off_t   fileSize   = FILE_SIZE;          // file size, bytes
+static int     wsyncMode  = WSYNC_MODE;         // write flush primitive
 static int     writeDelay = WRITE_DELAY;        // delay from start to write, milliseconds
 static int     readDelay  = READ_DELAY;         // delay from write end to read, milliseconds
 static int     repeats    = MEASURE_REPEATS;    // number of times to repeat test, for measurement precision
+static int     threads    = WALK_THREADS;       // number of page walk threads
+static int     pageMode   = PAGE_MODE;          // page size used by mapping
+static int     adviceMode = ADVICE_MODE;        // access pattern advice for mapping or file
+static int     populateMode = POPULATE_MODE;    // prefault mode, before timed walk
+static int     addressing = ADDRESSING_MODE;    // page walk addressing mode
+static int     walkSeed   = WALK_SEED;          // seed for random addressing
+static int     kernelMode = KERNEL_MODE;        // page walk kernel
+static size_t  walkStride = WALK_STRIDE;        // page walk stride, bytes, 0 means page size
+static int     sweepMode  = SWEEP_MODE;         // sweep mode
+static int     ramFactor  = RAM_FACTOR;         // size sweep limit, multiple of physical RAM
+static size_t  windowSize = WINDOW_SIZE;        // mapping window, bytes, 0 means whole file
+static size_t  windowOverlap = WINDOW_OVERLAP;  // overlap of adjacent windows, bytes
+static size_t  writeBehind = WRITE_BEHIND;      // write-behind chunk, bytes, 0 means not used
+static int     prepareMode = PREPARE_MODE;      // test file preparation mode
+static int     cacheMode  = CACHE_MODE;         // page cache state before read walk
+static int     latencyStep = LATENCY_STEP;      // latency sampling, every N-th walk step timed, 0=not used
+static int     timerMode  = TIMER_MODE;         // time source for all measurements
+static int     countersMode = COUNTERS;         // performance counters, 0=not used
+static int     kstatMode  = KSTAT;              // kernel counters deltas, 0=not used
+static int     devstatMode = DEVSTAT;           // block device statistics, 0=not used
+static int     outputMode = OUTPUT_MODE;        // results format
+static char*   planPath   = "";                 // test plan file path, empty if not used
+static int     outlierLimit = OUTLIERS;         // outliers rejection limit, MAD units, 0 = not used
+static char*   precisionString = PRECISION;     // median confidence interval width target, percents, 0 = fixed repeats
+static int     repeatsLimit = REPEATS_LIMIT;    // maximum number of passes per operation, adaptive repeats
+static int     budgetSeconds = BUDGET;          // wall clock budget per operation, seconds, 0 = not limited
+static int     durationSeconds = DURATION;      // soak duration, seconds, 0 = not used
+static int     intervalSeconds = INTERVAL;      // soak summary interval, seconds
+static int     rwmix      = RWMIX;              // reads percentage of mixed walk, -1 = not used
+static int     distribution = DISTRIBUTION;     // mixed walk access distribution
+static int     skew       = SKEW;               // mixed walk distribution skew, percents
+
+//--- Text data for interpreting command line options ---
+#define N_OUTPUT_MODES 3
+static char* outputModes[] = { "text", "json", "csv" };
+#define N_TIMER_MODES 3
+static char* timerModes[] = { "auto", "tsc", "monotonic" };
+#define N_PREPARE_MODES 4
+static char* prepareModes[] = { "each", "once", "fallocate", "sparse" };
+#define N_CACHE_MODES 4
+static char* cacheModes[] = { "cold", "drop", "warm", "hot" };
+#define N_WSYNC_MODES 8
+static char* wsyncModes[] = { "none", "fsync", "fdatasync", "msync", "msync_async",
+                              "sfr", "sfr_wait", "sfr_waitall" };
+static int wsyncValues[] = { 0, 0, 0, MS_SYNC, MS_ASYNC,
+                             SYNC_FILE_RANGE_WRITE, SYNC_FILE_RANGE_WRITE|SYNC_FILE_RANGE_WAIT_AFTER,
+                             SYNC_FILE_RANGE_WAIT_BEFORE|SYNC_FILE_RANGE_WRITE|SYNC_FILE_RANGE_WAIT_AFTER };
+#define N_PAGE_MODES 3
+static char* pageModes[] = { "4k", "thp", "hugetlb" };
+#define N_ADVICE_MODES 10
+static char* adviceModes[] = { "none", "normal", "sequential", "random", "willneed",
+                               "fnormal", "fsequential", "frandom", "fwillneed", "all" };
+static int adviceValues[] = { 0, MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED,
+                              POSIX_FADV_NORMAL, POSIX_FADV_SEQUENTIAL, POSIX_FADV_RANDOM, POSIX_FADV_WILLNEED };
+#define N_POPULATE_MODES 5
+static char* populateModes[] = { "none", "map_populate", "madv_populate_read", "madv_populate_write", "mlock" };
+static int populateValues[] = { 0, MAP_POPULATE, MADV_POPULATE_READ, MADV_POPULATE_WRITE, 0 };
+#define N_ADDRESSING_MODES 4
+static char* addressingModes[] = { "sequential", "reverse", "random", "strided" };
+#define N_KERNEL_MODES 8
+static char* kernelModes[] = { "touch", "memset", "memcpy", "sse2", "avx2", "avx512", "nt", "auto" };
+#define N_DISTRIBUTIONS 3
+static char* distributionModes[] = { "uniform", "zipf", "hotspot" };
+#define N_SWEEP_MODES 4
+static char* sweepModes[] = { "none", "stride", "size", "window" };
+static double adviceWriteLog[ADVICE_ALL];       // median write speeds for advices cycle
+static double adviceReadLog[ADVICE_ALL];        // median read speeds for advices cycle
+static off_t  sweepPoints[SWEEP_MAX];           // sweep points, bytes
+static double sweepWriteLog[SWEEP_MAX];         // median write speeds for sweep points
+static double sweepReadLog[SWEEP_MAX];          // median read speeds for sweep points
+static double sweepMapLog[SWEEP_MAX];           // window sweep: median read mmap() time per window, microseconds
+static double sweepWalkLog[SWEEP_MAX];          // window sweep: median read walk time per window, microseconds
+static double sweepUnmapLog[SWEEP_MAX];         // window sweep: median read munmap() time per window, microseconds
+static long long sweepResident[SWEEP_MAX];      // window sweep: resident size of mapped window, bytes, -1 if n/a
+static int sweepWindows[SWEEP_MAX];             // window sweep: number of windows per walk
 
 //--- Memory allocation and fill variables ---
 static size_t bufAlign = BUFFER_ALIGNMENT;      // page alignment required
-static size_t bufSize = 0;                      // size of buffer
 static char* diskData = NULL;                   // pointer to buffer
 static char setData = 0;                        // data pattern
 
@@ -109,16 +530,258 @@ static void* mapInput = NULL;     // input settings for mapping
 static size_t mapLength = 0;      // length of mapping address range
 static int mapProtect = PROT_WRITE|PROT_READ;   // memory protection attributes
 static int mapFlags = MAP_SHARED;               // sharing flags
-static int mapOffset = 0;                       // offset for file addressing
+static off_t mapOffset = 0;                     // offset for file addressing, start of mapped window
+
+//--- Page mode variables, detected by target file system ---
+#define FS_OTHER 5
+static long fsMagics[] = { EXT4_SUPER_MAGIC, XFS_SUPER_MAGIC, BTRFS_SUPER_MAGIC, TMPFS_MAGIC, HUGETLBFS_MAGIC };
+static char* fsNames[] = { "ext2/ext3/ext4", "xfs", "btrfs", "tmpfs", "hugetlbfs", "other" };
+static long fsMagic = 0;                        // file system magic number, from statfs
+static char* fsName = NULL;                     // file system name for visual
+static size_t hugePageSize = 0;                 // huge page size, 0 if huge pages not used
+static size_t pageSize = PAGE_WALK_STEP;        // system page size, from sysconf()
+static size_t walkStep = PAGE_WALK_STEP;        // page walk step, real page size for page mode or stride
+static char* smapsHugeFields[] =                // smaps fields of huge pages backed sizes, kilobytes
+    { "AnonHugePages:", "ShmemPmdMapped:", "FilePmdMapped:", "Shared_Hugetlb:", "Private_Hugetlb:", NULL };
+
+//--- Latency histogram, log-linear nanoseconds buckets ---
+typedef struct
+    {
+    unsigned long long counts[LAT_BUCKETS];  // number of samples per bucket
+    unsigned long long samples;              // total number of samples
+    unsigned long long maximum;              // maximum sample, nanoseconds
+    } LATENCY_HISTOGRAM;
+static LATENCY_HISTOGRAM passLatency;           // current pass, all threads and windows
+static LATENCY_HISTOGRAM writeLatency;          // all write passes
+static LATENCY_HISTOGRAM readLatency;           // all read passes
+
+//--- Page walk threads variables, one context per thread, partition of mapping per thread ---
+typedef struct
+    {
+    pthread_t thread;       // thread handle, result of pthread_create
+    int index;              // thread number, 0-based
+    int cpu;                // logical CPU for thread pinning, -1 if not pinned
+    char* base;             // start of this thread partition in the mapping
+    size_t length;          // length of this thread partition, bytes
+    int operation;          // WALK_WRITE or WALK_READ
+    char data;              // write pattern or read result
+    size_t pages;           // number of pages in this thread partition
+    uint64_t seed;          // random addressing: permutation seed
+    uint64_t mask;          // random addressing: permutation domain mask, 2^N-1 not below pages-1
+    int shift;              // random addressing: permutation mixing shift, N/2 rounded up
+    size_t stridePages;     // strided addressing: stride in pages, coprime with pages
+    char* buffer;           // memcpy kernel: source or destination buffer, one page
+    LATENCY_HISTOGRAM* histogram;  // timed walk: this thread page latencies, NULL if not timed
+    LATENCY_HISTOGRAM* mixHistograms[2];  // mixed walk: this thread write and read latencies
+    unsigned long long mixOps[2];         // mixed walk: number of writes and reads
+    unsigned long long mixNanoseconds[2]; // mixed walk: time of writes and reads, nanoseconds
+    long long counters[PERF_EVENTS];  // this thread performance counters deltas, -1 if n/a
+    double seconds;         // this thread walk time, seconds
+    double mbps;            // this thread walk speed, megabytes per second
+    } WALK_CONTEXT;
+static WALK_CONTEXT walkContexts[THREADS_MAX];  // per-thread contexts
+static size_t mixPages = 0;                     // mixed walk: number of pages in mapping
+static size_t mixHotPages = 0;                  // mixed walk: hotspot pages, first popularity ranks
+static uint64_t mixScramble = 1;                // mixed walk: rank to page multiplier, coprime with pages
+static double zipfZetan = 0.0;                  // mixed walk: Zipf normalization, zeta( pages, theta )
+static double zipfAlpha = 0.0;                  // mixed walk: Zipf 1 / ( 1 - theta )
+static double zipfEta = 0.0;                    // mixed walk: Zipf generator constant
+static double zipfHalf = 0.0;                   // mixed walk: Zipf 0.5 ^ theta
+static LATENCY_HISTOGRAM mixLatency[2];         // mixed walk: current pass write and read latencies
+static unsigned long long mixOps[2];            // mixed walk: current pass writes and reads
+static double mixMbps[2];                       // mixed walk: current pass write and read speeds, sum of threads
+static char (*kernelWrite)( char*, size_t, char, char* ) = NULL;  // write kernel, NULL for touch
+static char (*kernelRead)( char*, size_t, char, char* ) = NULL;   // read kernel, NULL for touch
+static pthread_barrier_t walkBarrier;           // common start point for all walk threads
+static pthread_barrier_t walkDoneBarrier;       // common stop point for walk threads reused by windows
+static int walkReuse = 0;                       // 1 means walk threads wait next range after walk, windows
+static int walkQuit = 0;                        // 1 means reused walk threads exit at next release
+static int walkCpus[THREADS_MAX];               // logical CPUs available for pinning
+static int walkCpusCount = 0;                   // number of valid entries in walkCpus[]
+static int kernelStatus = 0;                    // status of kernel selection, 0=supported
+
+//--- File fill threads variables, one context per thread, partition of file per thread ---
+typedef struct
+    {
+    pthread_t thread;       // thread handle, result of pthread_create
+    off_t offset;           // start of this thread partition in the file
+    off_t length;           // length of this thread partition, bytes
+    int status;             // fill status, 0=OK
+    } FILL_CONTEXT;
+static FILL_CONTEXT fillContexts[THREADS_MAX];  // per-thread contexts
+
+//--- Write-behind variables, walk thread publish progress per chunk, flusher thread follow it ---
+static pthread_t behindThread;                  // flusher thread handle
+static pthread_mutex_t behindMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t behindCond = PTHREAD_COND_INITIALIZER;
+static size_t behindProgress = 0;               // bytes dirtied by walk, published per chunk
+static int behindDone = 0;                      // walk done flag, all progress published
+static int behindStatus = 0;                    // flusher status, 0=OK, otherwise errno
+static int behindChunks = 0;                    // number of chunks flushed by flusher thread
+static double behindSeconds = 0.0;              // flusher thread busy time, seconds
+static unsigned long long stallCount = 0;       // number of page writes above STALL_THRESHOLD
+
+//--- Performance counters variables, main thread group opened at start, walk threads open own groups ---
+static char* perfNames[] = { "cycles", "instructions", "dTLB-load-misses",
+                             "page-faults", "major-faults", "context-switches" };
+static unsigned int perfTypes[] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+                                    PERF_TYPE_SOFTWARE, PERF_TYPE_SOFTWARE, PERF_TYPE_SOFTWARE };
+static unsigned long long perfConfigs[] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_DTLB | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 ),
+    PERF_COUNT_SW_PAGE_FAULTS, PERF_COUNT_SW_PAGE_FAULTS_MAJ, PERF_COUNT_SW_CONTEXT_SWITCHES };
+static int perfHandles[PERF_EVENTS];            // main thread counters file descriptors, -1 if not opened
+static int perfLeader = -1;                     // main thread group leader, -1 if no counters
+static int perfUserOnly = 0;                    // 1 if kernel counting not permitted, user space only
+static long long perfValues[PHASES][PERF_EVENTS];  // last pass deltas, -1 if n/a
+
+//--- Kernel counters variables, /proc/vmstat, /proc/self/io, /proc/pressure snapshots ---
+#define KSTAT_VMSTAT   0               // first /proc/vmstat field
+#define KSTAT_IO       13              // first /proc/self/io field
+#define KSTAT_PSI      18              // first /proc/pressure field, total stall time, microseconds
+#define KSTAT_FIELDS   22              // number of fields
+#define KSTAT_GAUGES   4               // nr_dirty and nr_writeback, fields 4 and 5, current values not events
+#define KSTAT_NA       LLONG_MIN       // field not available, deltas of gauges can be negative
+static char* kstatNames[] = { "pgfault", "pgmajfault", "pgpgin", "pgpgout", "nr_dirty", "nr_writeback",
+                              "pgscan_kswapd", "pgscan_direct", "pgsteal_kswapd", "pgsteal_direct",
+                              "thp_fault_alloc", "thp_file_mapped", "thp_split_pmd",
+                              "rchar", "wchar", "read_bytes", "write_bytes", "cancelled_write_bytes",
+                              "io_some_us", "io_full_us", "memory_some_us", "memory_full_us" };
+static long long kstatStart[KSTAT_FIELDS];      // snapshot at phase start, KSTAT_NA if n/a
+static long long kstatDelta[PHASES][KSTAT_FIELDS];  // last pass deltas, KSTAT_NA if n/a
+
+//--- Block device statistics variables, device backing target file by st_dev and sysfs ---
+// stat file fields: read IOs, read merges, read sectors, read ticks, write IOs, write merges,
+// write sectors, write ticks, in flight, IO ticks, time in queue, milliseconds for ticks
+#define DEV_READ_IOS     0
+#define DEV_READ_SECTORS 2
+#define DEV_READ_TICKS   3
+#define DEV_WRITE_IOS    4
+#define DEV_WRITE_SECTORS 6
+#define DEV_WRITE_TICKS  7
+#define DEV_QUEUE_TICKS  10
+static char devStatPath[PATH_MAX];              // stat file path, empty if device not resolved
+static char devNameBuffer[PATH_MAX];            // device name for visual
+static char* devName = devNameBuffer;
+static unsigned long long devStart[DEVSTAT_FIELDS];     // snapshot at phase start
+static long long devDelta[PHASES][DEVSTAT_FIELDS];      // last pass deltas, -1 if n/a
 
 //--- Numeric data for benchmarks results statistics ---
-static double readLog[REPEATS_MAX];    // array of read results, megabytes per second
-static double writeLog[REPEATS_MAX];   // array of write results, megabytes per second
-static int logCount = 0;               // number of actual log entries
+static double* readLog = NULL;         // array of read results, megabytes per second
+static double* writeLog = NULL;        // array of write results, megabytes per second
+static double* populateReadLog = NULL;        // array of read phase prefault results, megabytes per second
+static double* populateWriteLog = NULL;       // array of write phase prefault results, megabytes per second
+static double populateSeconds = 0.0;          // prefault time of last mapping, seconds
+static double* flushLog = NULL;               // array of write flush results, megabytes per second
+static double* dirtyLog = NULL;               // array of write walk without flush results, megabytes per second
+static double flushSeconds = 0.0;             // flush time of last write pass, seconds
+static double excludedSeconds = 0.0;          // not measured time inside last pass interval, seconds
+static double residentPercent = -1.0;         // part of file in page cache before last walk, -1 if n/a
+static int windowCount = 0;                   // number of windows of last walk by windows
+static long long windowBytes = 0;             // bytes accessed by last walk by windows, overlaps walked again included
+static double windowMapSeconds = 0.0;         // mmap() time of all windows of last walk, seconds
+static double windowWalkSeconds = 0.0;        // walk time of all windows of last walk, seconds
+static double windowUnmapSeconds = 0.0;       // munmap() time of all windows of last walk, seconds
+static long long windowResident = -1;         // resident size of first window before unmap, bytes, -1 if n/a
+static double* windowMapLog = NULL;           // read passes: mmap() time per window, microseconds
+static double* windowWalkLog = NULL;          // read passes: walk time per window, microseconds
+static double* windowUnmapLog = NULL;         // read passes: munmap() time per window, microseconds
+static double* mixedLog = NULL;               // array of mixed walk results, all accesses, megabytes per second
+static double** logList[] = { &readLog, &writeLog, &populateReadLog, &populateWriteLog,
+                              &flushLog, &dirtyLog, &windowMapLog, &windowWalkLog, &windowUnmapLog, &mixedLog,
+                              NULL };         // all logs, allocated and grown together
+static int logCount = 0;               // number of allocated log entries
+static double* statScratch = NULL;     // statistics scratch array, logCount entries, reordered by selection
+static double* statKept = NULL;        // statistics samples after outliers rejection, logCount entries
+static double statMedians[STAT_BOOTSTRAP];  // bootstrap medians
 static double resultMedian = 0.0;      // median speed, megabytes per second
 static double resultAverage = 0.0;     // average speed, megabytes per second
 static double resultMinimum = 0.0;     // minimum detected speed, megabytes per second
 static double resultMaximum = 0.0;     // maximum detected speed, megabytes per second
+static double resultStddev = 0.0;      // sample standard deviation, megabytes per second
+static double resultCv = 0.0;          // coefficient of variation, percents
+static double resultP5 = 0.0;          // 5th percentile, megabytes per second
+static double resultP95 = 0.0;         // 95th percentile, megabytes per second
+static double resultCiLow = 0.0;       // median 95% confidence interval low bound, bootstrap
+static double resultCiHigh = 0.0;      // median 95% confidence interval high bound, bootstrap
+static int resultSamples = 0;          // number of samples used, after outliers rejection
+static int resultOutliers = 0;         // number of samples rejected as outliers
+
+//--- Streaming quantile, P-square algorithm, 5 markers, constant memory ---
+typedef struct
+    {
+    double p;               // quantile, from 0.0 to 1.0
+    double q[5];            // markers heights, first samples before 5 samples
+    double n[5];            // markers positions, 1-based
+    double np[5];           // desired markers positions
+    double dn[5];           // desired positions increments
+    long long count;        // number of samples
+    } P2_QUANTILE;
+
+//--- Streaming statistics, Welford mean and variance, P-square quantiles ---
+typedef struct
+    {
+    long long count;        // number of samples
+    double mean;            // running mean
+    double m2;              // sum of squared deviations from mean
+    double minimum;         // minimum sample
+    double maximum;         // maximum sample
+    P2_QUANTILE p5;         // 5th percentile
+    P2_QUANTILE p50;        // median
+    P2_QUANTILE p95;        // 95th percentile
+    } STREAM_STAT;
+
+//--- Drift detection, two-sided CUSUM against baseline of first passes ---
+typedef struct
+    {
+    STREAM_STAT baseline;   // baseline passes, after start or after last drift
+    double high, low;       // upper and lower cumulative sums, baseline standard deviations
+    double highSum, lowSum; // sum of samples since cumulative sum was zero, for new level
+    long long highCount, lowCount;  // number of samples since cumulative sum was zero
+    int drifts;             // number of detected drifts
+    } DRIFT_STATE;
+
+static STREAM_STAT soakTotal[2];       // soak mode: all passes, write and read
+static STREAM_STAT soakInterval[2];    // soak mode: passes of current summary interval
+static DRIFT_STATE soakDrift[2];       // soak mode: drift detection state, write and read
+static struct timespec tsSoak;         // soak mode: start moment
+static int soakSummaries = 0;          // soak mode: number of periodic summaries
+static double precisionTarget = 0.0;   // median confidence interval width target, percents, 0 = fixed repeats
+static int writePasses = 0;            // number of write passes of last benchmark
+static int readPasses = 0;             // number of read passes of last benchmark
+static int writeWarmup = 0;            // number of write warm-up passes discarded, adaptive repeats
+static int readWarmup = 0;             // number of read warm-up passes discarded, adaptive repeats
+static double writeMedian = 0.0;       // median write speed of last benchmark, megabytes per second
+static double readMedian = 0.0;        // median read speed of last benchmark, megabytes per second
+
+//--- Time source variables, selected and calibrated at start ---
+static int timerStatus = 0;            // status of time source selection, 0=supported
+static double tscNanoseconds = 0.0;    // TSC: nanoseconds per tick, from calibration
+static double tscFrequency = 0.0;      // TSC: ticks per second, for visual
+static unsigned long long tscBase = 0; // TSC: tick at calibration start, time zero
+static unsigned long long timerOverhead = 0;    // minimum time of one timer read, nanoseconds
+static unsigned long long timerResolution = 0;  // minimum non-zero step of timer, nanoseconds
+
+//--- Machine readable results variables ---
+static FILE* machineFile = NULL;       // records stream, original stdout, NULL if text output
+static int machineRecords = 0;         // number of records written, for JSON separators
+static int benchmarkIndex = 0;         // current benchmark number, 0 for start conditions
+
+//--- Test plan variables, options of plan file and results of scenario runs ---
+static char* planTokens[PLAN_TOKENS];          // NAME=VALUE options, values can be comma separated list
+static int planTokenCount = 0;                 // number of options in plan file
+static int planCommonCount = 0;                // options before first scenario, used by all scenarios
+static char* planNames[PLAN_SCENARIOS];        // scenarios names
+static int planFirst[PLAN_SCENARIOS];          // first option of scenario
+static int planCount[PLAN_SCENARIOS];          // number of options of scenario
+static int planScenarios = 0;                  // number of scenarios
+static int scenarioIndex = 0;                  // current scenario run, 1-based, 0 if plan not used
+static char* scenarioName = "none";            // current scenario run name, for visual
+static char* planRunNames[PLAN_RUNS];          // scenario runs names
+static char* planRunOptions[PLAN_RUNS];        // scenario runs options, for visual
+static int planRunStatus[PLAN_RUNS];           // scenario runs status, 0=OK, 1=bad parameter
+static double planRunWrite[PLAN_RUNS];         // scenario runs write median, negative if not single benchmark
+static double planRunRead[PLAN_RUNS];          // scenario runs read median, negative if not single benchmark
+static int planInvalid = 0;                    // number of scenario runs skipped as bad parameter
 
 //--- Data for timings and benchmarks ---
 struct timespec ts1, ts2;              // start and end moments
@@ -137,22 +800,93 @@ static char sPath[]     = "path"     ,  // this for command line options names d
             sWdelay[]   = "wdelay"   ,
             sRdelay[]   = "rdelay"   ,
             sRepeats[]  = "repeats"  ,
+            sThreads[]  = "threads"  ,
+            sPages[]    = "pages"    ,
+            sAdvice[]   = "advice"   ,
+            sPopulate[] = "populate" ,
+            sAddressing[] = "addressing" ,
+            sSeed[]     = "seed"     ,
+            sKernel[]   = "kernel"   ,
+            sStride[]   = "stride"   ,
+            sSweep[]    = "sweep"    ,
+            sRamFactor[] = "ramfactor" ,
+            sWindow[]   = "window"   ,
+            sOverlap[]  = "overlap"  ,
+            sWriteBehind[] = "writebehind" ,
+            sPrepare[]  = "prepare"  ,
+            sCache[]    = "cache"    ,
+            sLatency[]  = "latency"  ,
+            sTimer[]    = "timer"    ,
+            sCounters[] = "counters" ,
+            sKstat[]    = "kstat"    ,
+            sDevstat[]  = "devstat"  ,
+            sOutput[]   = "output"   ,
+            sOutliers[] = "outliers" ,
+            sPlan[]     = "plan"     ,
+            sPrecision[] = "precision" ,
+            sMaxrepeats[] = "maxrepeats" ,
+            sBudget[]   = "budget"   ,
+            sDuration[] = "duration" ,
+            sInterval[] = "interval" ,
+            sRwmix[]    = "rwmix"    ,
+            sDistribution[] = "distribution" ,
+            sSkew[]     = "skew"     ,
             
             ssPath[]    = "file path"         ,    // this for start conditions visual
             ssSize[]    = "file size"         ,
-            ssWsync[]   = "wait write sync"   ,
+            ssWsync[]   = "write flush"       ,
             ssWdelay[]  = "write delay (ms)"  ,
             ssRdelay[]  = "read delay (ms)"   ,
             ssRepeats[] = "repeat times"      ,
+            ssThreads[] = "walk threads"      ,
+            ssPages[]   = "page mode"         ,
+            ssStep[]    = "page walk step"    ,
+            ssFs[]      = "file system"       ,
+            ssAdvice[]  = "access advice"     ,
+            ssPopulate[] = "prefault mode"    ,
+            ssAddressing[] = "walk addressing" ,
+            ssSeed[]    = "random seed"       ,
+            ssKernel[]  = "walk kernel"       ,
+            ssSweep[]   = "sweep mode"        ,
+            ssWindow[]  = "map window"        ,
+            ssOverlap[] = "window overlap"    ,
+            ssWriteBehind[] = "write-behind chunk" ,
+            ssPrepare[] = "file prepare"      ,
+            ssCache[]   = "read cache state"  ,
+            ssLatency[] = "latency sampling"  ,
+            ssTimer[]   = "timer"  ,
+            ssCounters[] = "perf counters"  ,
+            ssKstat[]   = "kernel counters"  ,
+            ssDevstat[] = "device statistics"  ,
+            ssDevice[]  = "block device"  ,
+            ssOutput[]  = "output format"  ,
+            ssScenario[] = "plan scenario" ,
+            ssOutliers[] = "outliers limit" ,
+            ssPrecision[] = "precision target %" ,
+            ssMaxrepeats[] = "repeats limit" ,
+            ssBudget[]  = "time budget, s" ,
+            ssDuration[] = "soak duration, s" ,
+            ssInterval[] = "soak interval, s" ,
+            ssRwmix[]   = "mixed reads %" ,
+            ssDistribution[] = "distribution" ,
+            ssSkew[]    = "skew %"   ,
             
             sMedian[]   = "Median"   ,             // this for result statistics median
             sAverage[]  = "Average"  ,
             sMinimum[]  = "Minimum"  ,
-            sMaximum[]  = "Maximum"  ;
+            sMaximum[]  = "Maximum"  ,
+            sStddev[]   = "Stddev"   ,
+            sCv[]       = "CV %"     ,
+            sP5[]       = "P5"       ,
+            sP95[]      = "P95"      ,
+            sCiLow[]    = "CI low"   ,
+            sCiHigh[]   = "CI high"  ,
+            sSamples[]  = "Samples"  ,
+            sOutliersCount[] = "Outliers" ;
 
 //--- Control block for command line parse, build IPB = Input Parameters Block ---
 typedef enum
-    { NOOPT, INTPARM, MEMPARM, SELPARM, STRPARM } OPTION_TYPES;
+    { NOOPT, INTPARM, MEMPARM, OFFPARM, SELPARM, STRPARM } OPTION_TYPES;
 typedef struct
     {
     char* name;             // pointer to parm. name string for recognition NAME=VALUE
@@ -161,22 +895,60 @@ typedef struct
     void* data;             // pointer to updated option variable
     OPTION_TYPES routine;   // select handling method for this entry
     } OPTION_ENTRY;
+typedef union               // saved value of option variable, restored between scenarios
+    {
+    int intValue;           // INTPARM and SELPARM
+    size_t memValue;        // MEMPARM
+    off_t offValue;         // OFFPARM
+    char* strValue;         // STRPARM
+    } OPTION_VALUE;
     
 //--- Entries for command line options, null-terminated list ---
 static OPTION_ENTRY ipb_list[] =
     {
         { sPath    ,  NULL ,  0 ,  &filePath   ,  STRPARM },
-        { sSize    ,  NULL ,  0 ,  &fileSize   ,  MEMPARM },
-        { sWsync   ,  NULL ,  0 ,  &wsyncMode  ,  INTPARM },
+        { sSize    ,  NULL ,  0 ,  &fileSize   ,  OFFPARM },
+        { sWsync   ,  wsyncModes , N_WSYNC_MODES , &wsyncMode , SELPARM },
         { sWdelay  ,  NULL ,  0 ,  &writeDelay ,  INTPARM },
         { sRdelay  ,  NULL ,  0 ,  &readDelay  ,  INTPARM },
         { sRepeats ,  NULL ,  0 ,  &repeats    ,  INTPARM },
+        { sThreads ,  NULL ,  0 ,  &threads    ,  INTPARM },
+        { sPages   ,  pageModes , N_PAGE_MODES , &pageMode , SELPARM },
+        { sAdvice  ,  adviceModes , N_ADVICE_MODES , &adviceMode , SELPARM },
+        { sPopulate , populateModes , N_POPULATE_MODES , &populateMode , SELPARM },
+        { sAddressing , addressingModes , N_ADDRESSING_MODES , &addressing , SELPARM },
+        { sSeed    ,  NULL ,  0 ,  &walkSeed   ,  INTPARM },
+        { sKernel  ,  kernelModes , N_KERNEL_MODES , &kernelMode , SELPARM },
+        { sStride  ,  NULL ,  0 ,  &walkStride ,  MEMPARM },
+        { sSweep   ,  sweepModes , N_SWEEP_MODES , &sweepMode , SELPARM },
+        { sRamFactor , NULL , 0 ,  &ramFactor  ,  INTPARM },
+        { sWindow  ,  NULL ,  0 ,  &windowSize ,  MEMPARM },
+        { sOverlap ,  NULL ,  0 ,  &windowOverlap , MEMPARM },
+        { sWriteBehind , NULL , 0 , &writeBehind ,  MEMPARM },
+        { sPrepare ,  prepareModes , N_PREPARE_MODES , &prepareMode , SELPARM },
+        { sCache   ,  cacheModes , N_CACHE_MODES , &cacheMode , SELPARM },
+        { sLatency ,  NULL ,  0 ,  &latencyStep ,  INTPARM },
+        { sTimer   ,  timerModes , N_TIMER_MODES , &timerMode , SELPARM },
+        { sCounters , NULL ,  0 ,  &countersMode , INTPARM },
+        { sKstat   ,  NULL ,  0 ,  &kstatMode  ,  INTPARM },
+        { sDevstat ,  NULL ,  0 ,  &devstatMode , INTPARM },
+        { sOutput  ,  outputModes , N_OUTPUT_MODES , &outputMode , SELPARM },
+        { sPlan    ,  NULL ,  0 ,  &planPath   , STRPARM },
+        { sOutliers , NULL ,  0 ,  &outlierLimit , INTPARM },
+        { sPrecision , NULL , 0 ,  &precisionString , STRPARM },
+        { sMaxrepeats , NULL , 0 , &repeatsLimit , INTPARM },
+        { sBudget  ,  NULL ,  0 ,  &budgetSeconds , INTPARM },
+        { sDuration , NULL ,  0 ,  &durationSeconds , INTPARM },
+        { sInterval , NULL ,  0 ,  &intervalSeconds , INTPARM },
+        { sRwmix   ,  NULL ,  0 ,  &rwmix      ,  INTPARM },
+        { sDistribution , distributionModes , N_DISTRIBUTIONS , &distribution , SELPARM },
+        { sSkew    ,  NULL ,  0 ,  &skew       ,  INTPARM },
         { NULL     ,  NULL ,  0 ,  NULL        ,  NOOPT   }
     };
 
 //--- Control block for start conditions parameters visual, bulid TPB = Transit Parameters Block ---
 typedef enum
-    { NOPRN, VDOUBLE, VINTEGER, MEMSIZE, SELECTOR, POINTER, HEX64, MHZ, STRNG } PRINT_TYPES;
+    { NOPRN, VDOUBLE, VINTEGER, MEMSIZE, OFFSIZE, SELECTOR, POINTER, HEX64, MHZ, STRNG } PRINT_TYPES;
 typedef struct
     {
     char* name;             // pointer to parameter name for visual NAME=VALUE 
@@ -189,11 +961,43 @@ typedef struct
 static PRINT_ENTRY tpb_list[] = 
     {
         { ssPath    ,  NULL ,  &filePath   ,  STRNG    },
-        { ssSize    ,  NULL ,  &fileSize   ,  MEMSIZE  },
-        { ssWsync   ,  NULL ,  &wsyncMode  ,  VINTEGER },
+        { ssSize    ,  NULL ,  &fileSize   ,  OFFSIZE  },
+        { ssWsync   ,  wsyncModes , &wsyncMode , SELECTOR },
         { ssWdelay  ,  NULL ,  &writeDelay ,  VINTEGER },
         { ssRdelay  ,  NULL ,  &readDelay  ,  VINTEGER },
         { ssRepeats ,  NULL ,  &repeats    ,  VINTEGER },
+        { ssThreads ,  NULL ,  &threads    ,  VINTEGER },
+        { ssPages   ,  pageModes , &pageMode ,  SELECTOR },
+        { ssStep    ,  NULL ,  &walkStep   ,  MEMSIZE  },
+        { ssFs      ,  NULL ,  &fsName     ,  STRNG    },
+        { ssAdvice  ,  adviceModes , &adviceMode , SELECTOR },
+        { ssPopulate , populateModes , &populateMode , SELECTOR },
+        { ssAddressing , addressingModes , &addressing , SELECTOR },
+        { ssSeed    ,  NULL ,  &walkSeed   ,  VINTEGER },
+        { ssKernel  ,  kernelModes , &kernelMode , SELECTOR },
+        { ssSweep   ,  sweepModes , &sweepMode ,  SELECTOR },
+        { ssWindow  ,  NULL ,  &windowSize ,  MEMSIZE  },
+        { ssOverlap ,  NULL ,  &windowOverlap , MEMSIZE },
+        { ssWriteBehind , NULL , &writeBehind , MEMSIZE },
+        { ssPrepare ,  prepareModes , &prepareMode , SELECTOR },
+        { ssCache   ,  cacheModes , &cacheMode , SELECTOR },
+        { ssLatency ,  NULL ,  &latencyStep , VINTEGER },
+        { ssTimer   ,  timerModes , &timerMode , SELECTOR },
+        { ssCounters , NULL ,  &countersMode , VINTEGER },
+        { ssKstat   ,  NULL ,  &kstatMode  ,  VINTEGER },
+        { ssDevstat ,  NULL ,  &devstatMode , VINTEGER },
+        { ssDevice  ,  NULL ,  &devName    ,  STRNG    },
+        { ssOutput  ,  outputModes , &outputMode , SELECTOR },
+        { ssScenario , NULL ,  &scenarioName , STRNG   },
+        { ssOutliers , NULL ,  &outlierLimit , VINTEGER },
+        { ssPrecision , NULL , &precisionString , STRNG },
+        { ssMaxrepeats , NULL , &repeatsLimit , VINTEGER },
+        { ssBudget  ,  NULL ,  &budgetSeconds , VINTEGER },
+        { ssDuration , NULL ,  &durationSeconds , VINTEGER },
+        { ssInterval , NULL ,  &intervalSeconds , VINTEGER },
+        { ssRwmix   ,  NULL ,  &rwmix      ,  VINTEGER },
+        { ssDistribution , distributionModes , &distribution , SELECTOR },
+        { ssSkew    ,  NULL ,  &skew       ,  VINTEGER },
         { NULL      ,  NULL ,  0           ,  NOPRN    }
     }; 
 
@@ -205,10 +1009,205 @@ static PRINT_ENTRY opb_list[] =
         { sAverage    , NULL    , &resultAverage    , VDOUBLE  },
         { sMinimum    , NULL    , &resultMinimum    , VDOUBLE  },
         { sMaximum    , NULL    , &resultMaximum    , VDOUBLE  },
+        { sStddev     , NULL    , &resultStddev     , VDOUBLE  },
+        { sCv         , NULL    , &resultCv         , VDOUBLE  },
+        { sP5         , NULL    , &resultP5         , VDOUBLE  },
+        { sP95        , NULL    , &resultP95        , VDOUBLE  },
+        { sCiLow      , NULL    , &resultCiLow      , VDOUBLE  },
+        { sCiHigh     , NULL    , &resultCiHigh     , VDOUBLE  },
+        { sSamples    , NULL    , &resultSamples    , VINTEGER },
+        { sOutliersCount , NULL , &resultOutliers   , VINTEGER },
         { NULL        , NULL    , 0                 , NOPRN    }
     };
 
 
+//--- Helper method for write one machine readable record ---
+// Schema is same for JSON and CSV: section, scenario, benchmark, operation, pass, name, value,
+// scenario is 0 if test plan not used, benchmark is 0 for start conditions and resource usage.
+// INPUT:   section = record group: condition, benchmark, pass, statistics, rusage
+//          operation = write, read or derived name, NULL if not applicable
+//          pass = 1-based pass number, 0 if not applicable
+//          name = value name, lower case, spaces and punctuation runs converted to underscore
+//          value = value text
+//          quoted = 1 if value is string, 0 if value is number
+//---
+void outputRecord( char* section, char* operation, int pass, char* name, char* value, int quoted )
+    {
+    char key[OUTPUT_NAME];
+    char* p = NULL;
+    int i = 0;
+    if ( machineFile == NULL ) return;
+    for ( p=name; ( *p != 0 )&&( i < ( OUTPUT_NAME - 1 ) ); p++ )
+        {
+        if ( isalnum( (unsigned char)*p ) ) { key[i++] = tolower( (unsigned char)*p ); }
+        else if ( ( i > 0 )&&( key[i-1] != '_' ) ) { key[i++] = '_'; }
+        }
+    if ( ( i > 0 )&&( key[i-1] == '_' ) ) { i--; }
+    key[i] = 0;
+    if ( outputMode == OUTPUT_JSON )
+        {
+        fprintf( machineFile, "%s\n{\"section\":\"%s\",\"scenario\":%d,\"benchmark\":%d,",
+                 machineRecords ? "," : "", section, scenarioIndex, benchmarkIndex );
+        if ( operation != NULL ) { fprintf( machineFile, "\"operation\":\"%s\",", operation ); }
+        else { fprintf( machineFile, "\"operation\":null," ); }
+        if ( pass > 0 ) { fprintf( machineFile, "\"pass\":%d,", pass ); }
+        else { fprintf( machineFile, "\"pass\":null," ); }
+        fprintf( machineFile, "\"name\":\"%s\",\"value\":", key );
+        if ( !quoted ) { fprintf( machineFile, "%s}", value ); }
+        else
+            {
+            fputc( '"', machineFile );
+            for ( p=value; *p!=0; p++ )
+                {
+                if ( ( *p == '"' )||( *p == '\\' ) ) { fputc( '\\', machineFile ); }
+                if ( (unsigned char)*p >= ' ' ) { fputc( *p, machineFile ); }
+                }
+            fprintf( machineFile, "\"}" );
+            }
+        }
+    else
+        {
+        fprintf( machineFile, "%s,%d,%d,%s,", section, scenarioIndex, benchmarkIndex, operation != NULL ? operation : "" );
+        if ( pass > 0 ) { fprintf( machineFile, "%d", pass ); }
+        fprintf( machineFile, ",%s,", key );
+        if ( !quoted ) { fprintf( machineFile, "%s\n", value ); }
+        else
+            {
+            fputc( '"', machineFile );
+            for ( p=value; *p!=0; p++ )
+                {
+                if ( *p == '"' ) { fputc( '"', machineFile ); }
+                fputc( *p, machineFile );
+                }
+            fprintf( machineFile, "\"\n" );
+            }
+        }
+    machineRecords++;
+    }
+
+//--- Helper method for write machine readable record with floating point value ---
+// Not finite values written as null for JSON and empty for CSV.
+// INPUT:   section, operation, pass, name = see outputRecord()
+//          value = number
+//---
+void outputDouble( char* section, char* operation, int pass, char* name, double value )
+    {
+    char text[OUTPUT_NAME];
+    if ( machineFile == NULL ) return;
+    if ( isfinite( value ) ) { snprintf( text, OUTPUT_NAME, "%.9g", value ); }
+    else { snprintf( text, OUTPUT_NAME, "%s", outputMode == OUTPUT_JSON ? "null" : "" ); }
+    outputRecord( section, operation, pass, name, text, 0 );
+    }
+
+//--- Helper method for write machine readable record with integer value ---
+// INPUT:   section, operation, pass, name = see outputRecord()
+//          value = number
+//---
+void outputInteger( char* section, char* operation, int pass, char* name, long long value )
+    {
+    char text[OUTPUT_NAME];
+    if ( machineFile == NULL ) return;
+    snprintf( text, OUTPUT_NAME, "%lld", value );
+    outputRecord( section, operation, pass, name, text, 0 );
+    }
+
+//--- Helper method for write parameters block as machine readable records, raw values ---
+// INPUT:   section = records section
+//          operation = operation name, NULL if not applicable
+//          print_control = parameters block, null-terminated list
+//---
+void outputBlock( char* section, char* operation, PRINT_ENTRY print_control[] )
+    {
+    char text[OUTPUT_NAME];
+    int i = 0;
+    if ( machineFile == NULL ) return;
+    for ( i=0; print_control[i].name!=NULL; i++ )
+        {
+        switch( print_control[i].routine )
+            {
+            case VDOUBLE:
+                outputDouble( section, operation, 0, print_control[i].name, *(double*)print_control[i].data );
+                break;
+            case VINTEGER:
+                outputInteger( section, operation, 0, print_control[i].name, *(int*)print_control[i].data );
+                break;
+            case MEMSIZE:
+                outputInteger( section, operation, 0, print_control[i].name, *(size_t*)print_control[i].data );
+                break;
+            case OFFSIZE:
+                outputInteger( section, operation, 0, print_control[i].name, *(off_t*)print_control[i].data );
+                break;
+            case SELECTOR:
+                outputRecord( section, operation, 0, print_control[i].name,
+                              print_control[i].values[*(int*)print_control[i].data], 1 );
+                break;
+            case POINTER:
+                snprintf( text, OUTPUT_NAME, "%p", *(void**)print_control[i].data );
+                outputRecord( section, operation, 0, print_control[i].name, text, 1 );
+                break;
+            case HEX64:
+            case MHZ:
+                outputInteger( section, operation, 0, print_control[i].name, *(unsigned long long*)print_control[i].data );
+                break;
+            case STRNG:
+                outputRecord( section, operation, 0, print_control[i].name, *(char**)print_control[i].data, 1 );
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+//--- Helper method for close machine readable records stream, at exit ---
+// INPUT:   machineFile
+// OUTPUT:  none, JSON document closed, machineFile closed and cleared
+//---
+void outputClose()
+    {
+    if ( machineFile == NULL ) return;
+    fflush( stdout );
+    if ( outputMode == OUTPUT_JSON ) { fprintf( machineFile, "\n]}\n" ); }
+    fclose( machineFile );
+    machineFile = NULL;
+    }
+
+//--- Helper method for open machine readable records stream ---
+// Records written to original stdout, console text printed by printf() moved to stderr,
+// stream closed at exit, document valid if benchmark stopped by error.
+// INPUT:   outputMode
+// OUTPUT:  status, 0=OK or text output, 3=error, messages output to console
+//---
+int outputOpen()
+    {
+    int handle = 0;
+    if ( outputMode == OUTPUT_TEXT ) return 0;
+    fflush( stdout );
+    handle = dup( STDOUT_FILENO );
+    if ( ( handle < 0 )||( dup2( STDERR_FILENO, STDOUT_FILENO ) < 0 ) )
+        {
+        printf( "\nOutput redirection error ( %s )\n", strerror(errno) );
+        return 3;
+        }
+    machineFile = fdopen( handle, "w" );
+    if ( machineFile == NULL )
+        {
+        printf( "\nOutput stream error ( %s )\n", strerror(errno) );
+        return 3;
+        }
+    machineRecords = 0;
+    benchmarkIndex = 0;
+    if ( outputMode == OUTPUT_JSON )
+        {
+        fprintf( machineFile, "{\"tool\":\"mapfile\",\"version\":\"0.09\",\"schema\":%d,\"records\":[", OUTPUT_SCHEMA );
+        }
+    else
+        {
+        fprintf( machineFile, "section,scenario,benchmark,operation,pass,name,value\n" );
+        }
+    atexit( outputClose );
+    return 0;
+    }
+
 //--- Helper method, get and print Linux application resource usage statistics ---
 void printResourceStatistics()
 {
@@ -239,9 +1238,22 @@ printf ( "IPC messages received            = %ld\n", usage.ru_msgrcv );
 printf ( "Signals received                 = %ld\n", usage.ru_nsignals );
 printf ( "Voluntary context switches       = %ld\n", usage.ru_nvcsw );
 printf ( "Involuntary context switches     = %ld\n", usage.ru_nivcsw );
+scenarioIndex = 0;
+benchmarkIndex = 0;
+outputInteger( "rusage", NULL, 0, "utime_us", (long long)usage.ru_utime.tv_sec * 1000000 + usage.ru_utime.tv_usec );
+outputInteger( "rusage", NULL, 0, "stime_us", (long long)usage.ru_stime.tv_sec * 1000000 + usage.ru_stime.tv_usec );
+outputInteger( "rusage", NULL, 0, "maxrss_kb", usage.ru_maxrss );
+outputInteger( "rusage", NULL, 0, "minflt", usage.ru_minflt );
+outputInteger( "rusage", NULL, 0, "majflt", usage.ru_majflt );
+outputInteger( "rusage", NULL, 0, "nswap", usage.ru_nswap );
+outputInteger( "rusage", NULL, 0, "inblock", usage.ru_inblock );
+outputInteger( "rusage", NULL, 0, "oublock", usage.ru_oublock );
+outputInteger( "rusage", NULL, 0, "nsignals", usage.ru_nsignals );
+outputInteger( "rusage", NULL, 0, "nvcsw", usage.ru_nvcsw );
+outputInteger( "rusage", NULL, 0, "nivcsw", usage.ru_nivcsw );
 }
 
-//--- Helper method for print memory size: bytes/KB/MB/GB, to scratch string ---
+//--- Helper method for print memory size: bytes/KB/MB/GB/TB, to scratch string ---
 // INPUT:   scratchPointer = pointer to destination string
 //          memsize = memory size for visual, bytes
 // OUTPUT:  number of chars write
@@ -249,8 +1261,9 @@ printf ( "Involuntary context switches     = %ld\n", usage.ru_nivcsw );
 #define KILO 1024
 #define MEGA 1024*1024
 #define GIGA 1024*1024*1024
+#define TERA 1024LL*1024*1024*1024
 #define PRINT_LIMIT 20
-int scratchMemorySize( char* scratchPointer, size_t memsize )
+int scratchMemorySize( char* scratchPointer, unsigned long long memsize )
     {
     double xd = memsize;
     int nchars = 0;
@@ -269,19 +1282,24 @@ int scratchMemorySize( char* scratchPointer, size_t memsize )
         xd /= MEGA;
         nchars = snprintf( scratchPointer, PRINT_LIMIT, "%.2lfM", xd );
         }
-    else
+    else if ( memsize < TERA )
         {
         xd /= GIGA;
         nchars = snprintf( scratchPointer, PRINT_LIMIT, "%.2lfG", xd );
         }
+    else
+        {
+        xd /= TERA;
+        nchars = snprintf( scratchPointer, PRINT_LIMIT, "%.2lfT", xd );
+        }
     return nchars;
     }
 
-//--- Helper method for print memory size: bytes/KB/MB/GB, to console ---
+//--- Helper method for print memory size: bytes/KB/MB/GB/TB, to console ---
 // INPUT:   memsize = memory size for visual, bytes
 // OUTPUT:  number of chars write
 //---
-int printMemorySize( size_t memsize )
+int printMemorySize( unsigned long long memsize )
     {
     double xd = memsize;
     int nchars = 0;
@@ -300,11 +1318,16 @@ int printMemorySize( size_t memsize )
         xd /= MEGA;
         nchars = printf( "%.2lfM", xd );
         }
-    else
+    else if ( memsize < TERA )
         {
         xd /= GIGA;
         nchars = printf( "%.2lfG", xd );
         }
+    else
+        {
+        xd /= TERA;
+        nchars = printf( "%.2lfT", xd );
+        }
     return nchars;
     }
 
@@ -317,7 +1340,107 @@ void printSelectedString( int select, char* names[] )
     printf( "%s", names[select] );
     }
 
+//--- Helper method for allocate or grow results logs and statistics scratch arrays ---
+// New entries blanked, existing entries kept.
+// INPUT:   count = required number of log entries
+// OUTPUT:  status, 0=allocated OK, 3=error, messages output to console, update logCount
+//---
+int reserveLogs( int count )
+    {
+    double* pointer = NULL;
+    int i = 0;
+    if ( count <= logCount ) return 0;
+    for ( i=0; logList[i]!=NULL; i++ )
+        {
+        pointer = realloc( *logList[i], count * sizeof( double ) );
+        if ( pointer == NULL )
+            {
+            printf( "\nResults log allocation error ( %s )\n", strerror(errno) );
+            return 3;
+            }
+        memset( pointer + logCount, 0, ( count - logCount ) * sizeof( double ) );
+        *logList[i] = pointer;
+        }
+    pointer = realloc( statScratch, count * sizeof( double ) );
+    if ( pointer == NULL )
+        {
+        printf( "\nStatistics allocation error ( %s )\n", strerror(errno) );
+        return 3;
+        }
+    statScratch = pointer;
+    pointer = realloc( statKept, count * sizeof( double ) );
+    if ( pointer == NULL )
+        {
+        printf( "\nStatistics allocation error ( %s )\n", strerror(errno) );
+        return 3;
+        }
+    statKept = pointer;
+    logCount = count;
+    return 0;
+    }
+
+//--- Helper method for select k-th smallest value, Hoare quickselect, O(n) average ---
+// Array reordered: entries before k not above result, entries after k not below result.
+// INPUT:   data = array, reordered
+//          count = number of entries
+//          k = 0-based rank of selected value
+// OUTPUT:  k-th smallest value
+//---
+double selectValue( double data[], int count, int k )
+    {
+    int left = 0, right = count - 1;
+    int i = 0, j = 0;
+    double pivot = 0.0, temp = 0.0;
+    while ( left < right )
+        {
+        pivot = data[ left + ( right - left ) / 2 ];
+        i = left;
+        j = right;
+        while ( i <= j )
+            {
+            while ( data[i] < pivot ) i++;
+            while ( data[j] > pivot ) j--;
+            if ( i <= j )
+                {
+                temp = data[i];
+                data[i] = data[j];
+                data[j] = temp;
+                i++;
+                j--;
+                }
+            }
+        if ( k <= j ) { right = j; }
+        else if ( k >= i ) { left = i; }
+        else break;
+        }
+    return data[k];
+    }
+
+//--- Helper method for calculate percentile, linear interpolation between closest ranks ---
+// Same as median for p = 0.5, average of middle pair if number of entries is even.
+// INPUT:   data = array, reordered
+//          count = number of entries, above 0
+//          p = percentile, from 0.0 to 1.0
+// OUTPUT:  percentile value
+//---
+double percentileValue( double data[], int count, double p )
+    {
+    double h = ( count - 1 ) * p;
+    int lo = (int)h;
+    int i = 0;
+    double x = selectValue( data, count, lo );
+    double y = 0.0;
+    if ( ( h > lo )&&( ( lo + 1 ) < count ) )
+        {
+        y = data[lo + 1];
+        for ( i=lo+2; i<count; i++ ) { if ( data[i] < y ) y = data[i]; }
+        x += ( h - lo ) * ( y - x );
+        }
+    return x;
+    }
+
 //--- Helper method for calculate median, average, minimum, maximum ---
+// Samples copied to scratch array, results log order not changed.
 // INPUT:   statArray[] = array of results
 //          statCount = number of actual results in the array, can be smaller than array size
 // OUTPUT:  update variables by input pointers:
@@ -328,9 +1451,12 @@ void calculateStatistics( double statArray[], int statCount,
                           double *statMin, double *statMax )
     {
     double statSum = 0.0;
-    double statTemp = 0.0;
-    int flag = 0;
     int i = 0;
+    *statMedian = 0.0;
+    *statAverage = 0.0;
+    *statMin = 0.0;
+    *statMax = 0.0;
+    if ( ( statCount <= 0 )||( statCount > logCount ) ) return;
     //--- Minimum, Maximum, Average ---
     *statMin = statArray[0];
     *statMax = statArray[0];
@@ -339,34 +1465,292 @@ void calculateStatistics( double statArray[], int statCount,
         if ( *statMin > statArray[i] ) { *statMin = statArray[i]; }
         if ( *statMax < statArray[i] ) { *statMax = statArray[i]; }
         statSum += statArray[i];
+        statScratch[i] = statArray[i];
         }
     *statAverage = statSum / statCount;
-    //--- Median, first ordering ---
-    flag = 1;
-    while ( flag == 1 )
+    //--- Median, selection at scratch copy ---
+    *statMedian = percentileValue( statScratch, statCount, 0.5 );
+    }
+
+//--- Helper method for calculate results distribution statistics, for summary ---
+// Optional outliers rejection: samples beyond outlierLimit * 1.4826 * MAD from median rejected,
+// other statistics calculated for kept samples. Median confidence interval by percentile bootstrap,
+// fixed seed, results reproducible.
+// INPUT:   statArray[] = array of results, order not changed
+//          statCount = number of actual results in the array
+//          outlierLimit
+// OUTPUT:  update resultMedian, resultAverage, resultMinimum, resultMaximum, resultStddev, resultCv,
+//          resultP5, resultP95, resultCiLow, resultCiHigh, resultSamples, resultOutliers
+//---
+void calculateDistribution( double statArray[], int statCount )
+    {
+    double median = 0.0, mad = 0.0, limit = 0.0, sum = 0.0;
+    uint64_t random = STAT_SEED;
+    int kept = 0;
+    int i = 0, b = 0;
+    resultStddev = NAN;
+    resultCv = NAN;
+    resultP5 = 0.0;
+    resultP95 = 0.0;
+    resultCiLow = 0.0;
+    resultCiHigh = 0.0;
+    resultSamples = 0;
+    resultOutliers = 0;
+    resultMedian = 0.0;
+    resultAverage = 0.0;
+    resultMinimum = 0.0;
+    resultMaximum = 0.0;
+    if ( ( statCount <= 0 )||( statCount > logCount ) ) return;
+    //--- Outliers rejection by median absolute deviation ---
+    for ( i=0; i<statCount; i++ ) { statKept[i] = statArray[i]; }
+    kept = statCount;
+    if ( ( outlierLimit > 0 )&&( statCount > 2 ) )
+        {
+        for ( i=0; i<statCount; i++ ) { statScratch[i] = statArray[i]; }
+        median = percentileValue( statScratch, statCount, 0.5 );
+        for ( i=0; i<statCount; i++ ) { statScratch[i] = fabs( statArray[i] - median ); }
+        mad = percentileValue( statScratch, statCount, 0.5 );
+        limit = outlierLimit * STAT_MAD_SCALE * mad;
+        if ( limit > 0.0 )
+            {
+            kept = 0;
+            for ( i=0; i<statCount; i++ )
+                {
+                if ( fabs( statArray[i] - median ) <= limit ) { statKept[kept++] = statArray[i]; }
+                }
+            }
+        }
+    resultSamples = kept;
+    resultOutliers = statCount - kept;
+    //--- Median, average, minimum, maximum, standard deviation ---
+    calculateStatistics( statKept, kept, &resultMedian, &resultAverage, &resultMinimum, &resultMaximum );
+    if ( kept > 1 )
+        {
+        for ( i=0; i<kept; i++ ) { sum += ( statKept[i] - resultAverage ) * ( statKept[i] - resultAverage ); }
+        resultStddev = sqrt( sum / ( kept - 1 ) );
+        if ( resultAverage != 0.0 ) { resultCv = resultStddev * 100.0 / resultAverage; }
+        }
+    //--- Percentiles, scratch array is copy of kept samples after calculateStatistics() ---
+    resultP5 = percentileValue( statScratch, kept, 0.05 );
+    resultP95 = percentileValue( statScratch, kept, 0.95 );
+    //--- Median confidence interval, percentile bootstrap ---
+    for ( b=0; b<STAT_BOOTSTRAP; b++ )
+        {
+        for ( i=0; i<kept; i++ )
+            {
+            random ^= random << 13;
+            random ^= random >> 7;
+            random ^= random << 17;
+            statScratch[i] = statKept[ random % kept ];
+            }
+        statMedians[b] = percentileValue( statScratch, kept, 0.5 );
+        }
+    resultCiLow = percentileValue( statMedians, STAT_BOOTSTRAP, 0.025 );
+    resultCiHigh = percentileValue( statMedians, STAT_BOOTSTRAP, 0.975 );
+    }
+
+//--- Helper method for detect warm-up passes, MSER truncation rule ---
+// Number of leading passes d selected from 0 to count/2 for minimum of marginal standard error
+// of remaining passes: sum( ( x[i] - mean )^2 ) / ( count - d )^2, i from d to count-1.
+// INPUT:   statArray[] = array of results, pass order
+//          statCount = number of actual results in the array
+// OUTPUT:  number of leading warm-up passes, 0 if not detected or less than WARMUP_MIN passes
+//---
+int detectWarmup( double statArray[], int statCount )
+    {
+    double sum = 0.0, sumSquares = 0.0, score = 0.0, best = -1.0;
+    double n = 0.0;
+    int warmup = 0;
+    int i = 0;
+    if ( statCount < WARMUP_MIN ) return 0;
+    for ( i=statCount-1; i>=0; i-- )
+        {
+        sum += statArray[i];
+        sumSquares += statArray[i] * statArray[i];
+        if ( i > ( statCount / 2 ) ) continue;
+        n = statCount - i;
+        score = ( sumSquares - sum * sum / n ) / ( n * n );
+        if ( ( best < 0.0 )||( score <= best ) )
+            {
+            best = score;
+            warmup = i;
+            }
+        }
+    return warmup;
+    }
+
+//--- Helper method for initialize streaming quantile ---
+// INPUT:   quantile = P-square estimator
+//          p = quantile, from 0.0 to 1.0
+// OUTPUT:  quantile cleared
+//---
+void p2Clear( P2_QUANTILE* quantile, double p )
+    {
+    memset( quantile, 0, sizeof( P2_QUANTILE ) );
+    quantile->p = p;
+    quantile->dn[1] = p / 2.0;
+    quantile->dn[2] = p;
+    quantile->dn[3] = ( 1.0 + p ) / 2.0;
+    quantile->dn[4] = 1.0;
+    }
+
+//--- Helper method for add sample to streaming quantile, P-square algorithm ---
+// Markers adjusted by piecewise-parabolic prediction, linear if parabolic out of order.
+// INPUT:   quantile = P-square estimator
+//          x = sample
+// OUTPUT:  quantile markers updated
+//---
+void p2Add( P2_QUANTILE* quantile, double x )
+    {
+    double* q = quantile->q;
+    double* n = quantile->n;
+    double d = 0.0, qp = 0.0;
+    int i = 0, k = 0, ds = 0;
+    if ( quantile->count < 5 )
+        {
+        q[quantile->count++] = x;
+        if ( quantile->count < 5 ) return;
+        for ( i=1; i<5; i++ )
+            {
+            for ( k=i; ( k>0 )&&( q[k-1] > q[k] ); k-- ) { d = q[k]; q[k] = q[k-1]; q[k-1] = d; }
+            }
+        for ( i=0; i<5; i++ ) { n[i] = i + 1; }
+        quantile->np[0] = 1.0;
+        quantile->np[1] = 1.0 + 2.0 * quantile->p;
+        quantile->np[2] = 1.0 + 4.0 * quantile->p;
+        quantile->np[3] = 3.0 + 2.0 * quantile->p;
+        quantile->np[4] = 5.0;
+        return;
+        }
+    //--- Cell of new sample, extreme markers follow minimum and maximum ---
+    if ( x < q[0] ) { q[0] = x; k = 0; }
+    else if ( x >= q[4] ) { q[4] = x; k = 3; }
+    else { for ( k=0; ( k<3 )&&( x >= q[k+1] ); k++ ); }
+    for ( i=k+1; i<5; i++ ) { n[i] += 1.0; }
+    for ( i=0; i<5; i++ ) { quantile->np[i] += quantile->dn[i]; }
+    //--- Adjust middle markers ---
+    for ( i=1; i<4; i++ )
         {
-        flag = 0;
-        for ( i=0; i<(statCount-1); i++ )
+        d = quantile->np[i] - n[i];
+        if ( ( ( d >= 1.0 )&&( ( n[i+1] - n[i] ) > 1.0 ) )||( ( d <= -1.0 )&&( ( n[i-1] - n[i] ) < -1.0 ) ) )
             {
-            if ( statArray[i] > statArray[i+1] )
+            ds = ( d >= 0.0 ) ? 1 : -1;
+            qp = q[i] + ds / ( n[i+1] - n[i-1] ) *
+                 ( ( n[i] - n[i-1] + ds ) * ( q[i+1] - q[i] ) / ( n[i+1] - n[i] ) +
+                   ( n[i+1] - n[i] - ds ) * ( q[i] - q[i-1] ) / ( n[i] - n[i-1] ) );
+            if ( ( qp <= q[i-1] )||( qp >= q[i+1] ) )
                 {
-                statTemp = statArray[i];
-                statArray[i] = statArray[i+1];
-                statArray[i+1] = statTemp;
-                flag = 1;
+                qp = q[i] + ds * ( q[i+ds] - q[i] ) / ( n[i+ds] - n[i] );
                 }
+            q[i] = qp;
+            n[i] += ds;
             }
         }
-    if ( ( statCount % 2 ) == 0 )
-        {  // median if array length EVEN, average of middle pair
-        i = statCount / 2;
-        *statMedian = ( statArray[i-1] + statArray[i] ) / 2.0;
+    quantile->count++;
+    }
+
+//--- Helper method for get streaming quantile value ---
+// Exact percentile of stored samples if less than 5 samples.
+// INPUT:   quantile = P-square estimator
+// OUTPUT:  quantile estimation, 0 if no samples
+//---
+double p2Value( P2_QUANTILE* quantile )
+    {
+    double first[5];
+    int i = 0;
+    if ( quantile->count >= 5 ) return quantile->q[2];
+    if ( quantile->count == 0 ) return 0.0;
+    for ( i=0; i<quantile->count; i++ ) { first[i] = quantile->q[i]; }
+    return percentileValue( first, quantile->count, quantile->p );
+    }
+
+//--- Helper method for initialize streaming statistics ---
+void streamClear( STREAM_STAT* stat )
+    {
+    stat->count = 0;
+    stat->mean = 0.0;
+    stat->m2 = 0.0;
+    stat->minimum = 0.0;
+    stat->maximum = 0.0;
+    p2Clear( &stat->p5, 0.05 );
+    p2Clear( &stat->p50, 0.5 );
+    p2Clear( &stat->p95, 0.95 );
+    }
+
+//--- Helper method for add sample to streaming statistics, Welford method ---
+void streamAdd( STREAM_STAT* stat, double x )
+    {
+    double delta = x - stat->mean;
+    if ( ( stat->count == 0 )||( x < stat->minimum ) ) { stat->minimum = x; }
+    if ( ( stat->count == 0 )||( x > stat->maximum ) ) { stat->maximum = x; }
+    stat->count++;
+    stat->mean += delta / stat->count;
+    stat->m2 += delta * ( x - stat->mean );
+    p2Add( &stat->p5, x );
+    p2Add( &stat->p50, x );
+    p2Add( &stat->p95, x );
+    }
+
+//--- Helper method for sample standard deviation of streaming statistics, NaN if less than 2 samples ---
+double streamStddev( STREAM_STAT* stat )
+    {
+    if ( stat->count < 2 ) return NAN;
+    return sqrt( stat->m2 / ( stat->count - 1 ) );
+    }
+
+//--- Helper method for drift detection, sustained change point of throughput ---
+// Baseline = mean and standard deviation of DRIFT_BASELINE passes, then two-sided CUSUM
+// of standardized samples with slack DRIFT_K, drift if sum above DRIFT_H. Change point is
+// first sample after cumulative sum was last zero, new level is mean of samples after it.
+// Baseline learned again after drift.
+// INPUT:   drift = detection state
+//          x = sample
+//          oldLevel, newLevel = pointers for baseline mean and new level, updated if drift detected
+//          changeSamples = pointer for number of samples since change point
+// OUTPUT:  1 if drift detected, otherwise 0
+//---
+int driftAdd( DRIFT_STATE* drift, double x, double* oldLevel, double* newLevel, long long* changeSamples )
+    {
+    double sigma = 0.0, z = 0.0;
+    if ( drift->baseline.count < DRIFT_BASELINE )
+        {
+        streamAdd( &drift->baseline, x );
+        return 0;
+        }
+    sigma = streamStddev( &drift->baseline );
+    if ( !( sigma >= DRIFT_SIGMA_MIN * fabs( drift->baseline.mean ) ) )
+        {
+        sigma = DRIFT_SIGMA_MIN * fabs( drift->baseline.mean );
+        }
+    if ( sigma <= 0.0 ) return 0;
+    z = ( x - drift->baseline.mean ) / sigma;
+    drift->high += z - DRIFT_K;
+    drift->low += -z - DRIFT_K;
+    if ( drift->high <= 0.0 ) { drift->high = 0.0; drift->highSum = 0.0; drift->highCount = 0; }
+    else { drift->highSum += x; drift->highCount++; }
+    if ( drift->low <= 0.0 ) { drift->low = 0.0; drift->lowSum = 0.0; drift->lowCount = 0; }
+    else { drift->lowSum += x; drift->lowCount++; }
+    if ( ( drift->high <= DRIFT_H )&&( drift->low <= DRIFT_H ) ) return 0;
+    if ( drift->high > DRIFT_H )
+        {
+        *newLevel = drift->highSum / drift->highCount;
+        *changeSamples = drift->highCount;
         }
     else
-        {  // median if array length ODD, middle element
-        i = statCount/2;
-        *statMedian = statArray[i];
+        {
+        *newLevel = drift->lowSum / drift->lowCount;
+        *changeSamples = drift->lowCount;
         }
+    *oldLevel = drift->baseline.mean;
+    drift->drifts++;
+    streamClear( &drift->baseline );
+    drift->high = 0.0;
+    drift->low = 0.0;
+    drift->highSum = 0.0;
+    drift->lowSum = 0.0;
+    drift->highCount = 0;
+    drift->lowCount = 0;
+    return 1;
     }
 
 //--- Handler for Receive console input (command line, text file or GUI shell) data to IPB ---
@@ -390,6 +1774,9 @@ char** pPatterns = NULL;        // pointer to pointer to pattern strings
 int* pInt = NULL;               // pointer to integer (32b) for variable store
 size_t* pSize = NULL;           // transit pointer to block size, parse control
 size_t kSize = 0;               // transit value of block size, parse control
+off_t* pOffset = NULL;          // transit pointer to file size, parse control
+unsigned long long kLong = 0;   // transit 64-bit value of block or file size
+unsigned long long kUnits = 0;  // units of block or file size, 0 if invalid
 char c = 0;                     // transit storage for char
 #define SMIN 3                  // minimum option string length, example a=b
 #define SMAX 81                 // maximum option string length
@@ -463,46 +1850,68 @@ for ( i=1; i<pCount; i++ )      // cycle for command line options
                     break;
                     }
                 case MEMPARM:  // support memory block size parameters
+                case OFFPARM:  // support file size parameters, 64-bit for 32-bit build
                     {
-                    k1 = 0;
+                    kUnits = 0;
                     k2 = strlen( pValue );
                     c = pValue[k2-1];
                     if ( isdigit(c) != 0 )
                         {
-                        k1 = 1;             // no units kilo, mega, giga
+                        kUnits = 1;         // no units kilo, mega, giga, tera
                         }
                     else if ( c == 'K' )    // K means kilobytes
                         {
-                        k2--;               // last char not a digit K/M/G
-                        k1 = 1024;
+                        k2--;               // last char not a digit K/M/G/T
+                        kUnits = 1024;
                         }
                     else if ( c == 'M' )    // M means megabytes
                         {
                         k2--;
-                        k1 = 1024*1024;
+                        kUnits = 1024*1024;
                         }
                     else if ( c == 'G' )    // G means gigabytes
                         {
                         k2--;
-                        k1 = 1024*1024*1024;
+                        kUnits = 1024*1024*1024;
+                        }
+                    else if ( c == 'T' )    // T means terabytes
+                        {
+                        k2--;
+                        kUnits = 1024LL*1024*1024*1024;
                         }
                     for ( k=0; k<k2; k++ )
                         {
                         if ( isdigit( pValue[k] ) == 0 )
                             {
-                            k1 = 0;
+                            kUnits = 0;
+                            }
+                        }
+                    if ( kUnits != 0 )
+                        {
+                        kLong = strtoull( pValue, NULL, 10 );   // convert string to 64-bit integer
+                        if ( ( kLong > ( LLONG_MAX / kUnits ) )||
+                             ( ( t == MEMPARM )&&( ( kLong * kUnits ) > SIZE_MAX ) ) )
+                            {
+                            kUnits = 0;     // value not fits variable
                             }
                         }
-                    if ( k1==0 )
+                    if ( kUnits==0 )
                         {
                         printf( "ERROR, NOT A BLOCK SIZE: %s\n", pValue );
                         return 1;
                         }
-                    k = atoi( pValue );   // convert string to integer
-                    kSize = k;
-                    kSize *= k1;
-                    pSize = (size_t *) parse_control[j].data;
-                    *pSize = kSize;
+                    kLong *= kUnits;
+                    if ( t == MEMPARM )
+                        {
+                        kSize = kLong;
+                        pSize = (size_t *) parse_control[j].data;
+                        *pSize = kSize;
+                        }
+                    else
+                        {
+                        pOffset = (off_t *) parse_control[j].data;
+                        *pOffset = kLong;
+                        }
                     break;
                     }
                 case SELPARM:    // support parameters selected from text names
@@ -521,6 +1930,17 @@ for ( i=1; i<pCount; i++ )      // cycle for command line options
                             break;
                             }
                         }
+                    if ( ( k2 != 0 )&&( parse_control[j].data == &wsyncMode )&&
+                         ( isdigit( pValue[0] ) != 0 )&&( strlen( pValue ) == 1 ) )
+                        {   // numeric index accepted for wsync only, compatible with old numeric option
+                        k = pValue[0] - '0';
+                        if ( k < k1 )
+                            {
+                            pInt = (int *) parse_control[j].data;
+                            *pInt = k;
+                            k2 = 0;
+                            }
+                        }
                     if ( k2 != 0 )
                         {
                         printf( "ERROR, VALUE INVALID: %s\n", pAll );
@@ -570,6 +1990,7 @@ char* cp = NULL;                 // pointer to char
 char** ccp = NULL;               // pointer to array of pointers to strings
 size_t* sizep = 0;               // pointer to block size variable
 size_t size = 0;                 // block size variable
+off_t* offp = NULL;              // pointer to file size variable
 // cycle for print parameters strings
 for ( i=0; print_control[i].name!=NULL; i++ )
     {
@@ -603,6 +2024,12 @@ for ( i=0; print_control[i].name!=NULL; i++ )
             printMemorySize( size );
             break;
             }
+        case OFFSIZE:  // file size parameter, 64-bit
+            {
+            offp = (off_t *) print_control[i].data;
+            printMemorySize( *offp );
+            break;
+            }
         case SELECTOR:  // pool of text names parameter
             {
             kp = (int *) print_control[i].data;
@@ -667,396 +2094,4136 @@ void handlerProgress( char stepName[], int stepNumber, double statArray[] )
 	  );
     }
 
-//---------- Application entry point -------------------------------------------
-
-int main( int argc, char** argv )
-{
-//--- Start message ---
-printf( "\n%s\n\n", TITLE );
+//--- Helper method for calculate time interval between two moments ---
+// INPUT:   tStart = start moment
+//          tStop = end moment
+// OUTPUT:  time interval, seconds
+//---
+double secondsDelta( struct timespec* tStart, struct timespec* tStop )
+    {
+    double xs = tStop->tv_sec - tStart->tv_sec;
+    double xn = tStop->tv_nsec - tStart->tv_nsec;
+    return xs + xn * TIME_TO_SECONDS;
+    }
 
-//--- Parse command line ---
-if ( handlerInput( argc, argv, ipb_list ) != 0 ) return 1;
+//--- Helper method for read nanoseconds counter, time source for all measurements ---
+// INPUT:   timerMode = selected time source, TIMER_TSC or TIMER_MONOTONIC
+// OUTPUT:  monotonic time, nanoseconds
+//---
+static inline unsigned long long readNanoseconds()
+    {
+    struct timespec ts;
+#ifdef KERNELS_X86
+    if ( timerMode == TIMER_TSC )
+        {
+        _mm_lfence();  // previous loads and stores completed before TSC read
+        return ( __rdtsc() - tscBase ) * tscNanoseconds;
+        }
+#endif
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    }
 
-//--- Title string for test conditions ---
-printf( "Start conditions:\n" );
+//--- Helper method for read time moment, selected time source as timespec ---
+// INPUT:   ts = pointer to timespec, updated
+// OUTPUT:  status, 0 always, same as clock_gettime() OK
+//---
+int readTime( struct timespec* ts )
+    {
+    unsigned long long ns = readNanoseconds();
+    ts->tv_sec = ns / 1000000000ULL;
+    ts->tv_nsec = ns % 1000000000ULL;
+    return 0;
+    }
 
-//--- Print transit (config) parameters ---
+//--- Helper method for short interval with timer read overhead subtracted ---
+// INPUT:   ns1 = start moment, nanoseconds
+//          ns2 = end moment, nanoseconds
+// OUTPUT:  interval, nanoseconds, 0 if not above overhead
+//---
+static inline unsigned long long intervalNanoseconds( unsigned long long ns1, unsigned long long ns2 )
+    {
+    unsigned long long ns = ns2 - ns1;
+    return ns > timerOverhead ? ns - timerOverhead : 0;
+    }
+
+//--- Helper method for select and calibrate time source, measure its overhead and resolution ---
+// TSC calibrated by busy wait TIMER_CALIBRATE nanoseconds of CLOCK_MONOTONIC_RAW,
+// this clock not adjusted by NTP. Overhead is minimum of back-to-back reads,
+// resolution is minimum non-zero step.
+// INPUT:   timerMode = requested time source, auto means TSC if invariant TSC reported by CPUID
+// OUTPUT:  status, 0=time source supported, 1=not supported by CPU or build
+//          update timerMode if auto, tscNanoseconds, tscFrequency, tscBase,
+//          timerOverhead, timerResolution
+//---
+int selectTimer()
+    {
+    unsigned long long ns1 = 0, ns2 = 0, delta = 0;
+    int i = 0;
+#ifdef KERNELS_X86
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    int invariant = 0;
+    struct timespec tsRaw1, tsRaw2;
+    unsigned long long tsc1 = 0, tsc2 = 0;
+    double rawSeconds = 0.0;
+    if ( __get_cpuid( 0x80000007, &eax, &ebx, &ecx, &edx ) ) { invariant = ( edx >> 8 ) & 1; }
+    if ( timerMode == TIMER_AUTO ) { timerMode = invariant ? TIMER_TSC : TIMER_MONOTONIC; }
+    if ( timerMode == TIMER_TSC )
+        {
+        if ( !invariant ) return 1;
+        clock_gettime( CLOCK_MONOTONIC_RAW, &tsRaw1 );
+        tsc1 = __rdtsc();
+        do  {
+            clock_gettime( CLOCK_MONOTONIC_RAW, &tsRaw2 );
+            tsc2 = __rdtsc();
+            rawSeconds = secondsDelta( &tsRaw1, &tsRaw2 );
+            } while ( rawSeconds < TIMER_CALIBRATE * TIME_TO_SECONDS );
+        tscFrequency = ( tsc2 - tsc1 ) / rawSeconds;
+        tscNanoseconds = 1000000000.0 / tscFrequency;
+        tscBase = tsc1;
+        }
+#else
+    if ( timerMode == TIMER_AUTO ) { timerMode = TIMER_MONOTONIC; }
+    if ( timerMode == TIMER_TSC ) return 1;
+#endif
+    timerOverhead = ~0ULL;
+    timerResolution = ~0ULL;
+    for ( i=0; i<TIMER_PROBES; i++ )
+        {
+        ns1 = readNanoseconds();
+        ns2 = readNanoseconds();
+        delta = ns2 - ns1;
+        if ( delta < timerOverhead ) { timerOverhead = delta; }
+        if ( ( delta != 0 )&&( delta < timerResolution ) ) { timerResolution = delta; }
+        }
+    if ( timerResolution == ~0ULL ) { timerResolution = 0; }
+    return 0;
+    }
+
+//--- Helper method for print time source parameters ---
+// INPUT:   timerMode, tscFrequency, timerOverhead, timerResolution
+// OUTPUT:  none, messages output to console
+//---
+void printTimer()
+    {
+    if ( timerMode == TIMER_TSC )
+        {
+        printf( "Timer: invariant TSC %.3f MHz, calibrated by CLOCK_MONOTONIC_RAW", tscFrequency / 1000000.0 );
+        }
+    else
+        {
+        printf( "Timer: CLOCK_MONOTONIC" );
+        }
+    printf( ", read overhead %llu ns, resolution %llu ns\n", timerOverhead, timerResolution );
+    }
+
+//--- Helper method for clear latency histogram ---
+// INPUT:   histogram = pointer to histogram
+//---
+void latencyClear( LATENCY_HISTOGRAM* histogram )
+    {
+    memset( histogram, 0, sizeof( LATENCY_HISTOGRAM ) );
+    }
+
+//--- Helper method for add sample to latency histogram ---
+// Values below LAT_SUB stored exactly, above it bucket is power of 2 range
+// and linear sub-bucket by LAT_SUB_BITS bits after most significant bit.
+// INPUT:   histogram = pointer to histogram
+//          ns = sample, nanoseconds
+//---
+static inline void latencyAdd( LATENCY_HISTOGRAM* histogram, unsigned long long ns )
+    {
+    int index = ns;
+    int bits = 0;
+    if ( ns >= LAT_SUB )
+        {
+        bits = 63 - __builtin_clzll( ns );
+        if ( bits > ( LAT_MAX_BITS - 1 ) ) { bits = LAT_MAX_BITS - 1; ns = ( 1ULL << LAT_MAX_BITS ) - 1; }
+        index = ( bits - LAT_SUB_BITS + 1 ) * LAT_SUB + ( ( ns >> ( bits - LAT_SUB_BITS ) ) & ( LAT_SUB - 1 ) );
+        }
+    histogram->counts[index]++;
+    histogram->samples++;
+    if ( ns > histogram->maximum ) { histogram->maximum = ns; }
+    }
+
+//--- Helper method for merge latency histograms ---
+// INPUT:   destination = pointer to histogram, updated
+//          source = pointer to added histogram
+//---
+void latencyMerge( LATENCY_HISTOGRAM* destination, LATENCY_HISTOGRAM* source )
+    {
+    int i = 0;
+    for ( i=0; i<LAT_BUCKETS; i++ ) { destination->counts[i] += source->counts[i]; }
+    destination->samples += source->samples;
+    if ( source->maximum > destination->maximum ) { destination->maximum = source->maximum; }
+    }
+
+//--- Helper method for get percentile of latency histogram ---
+// INPUT:   histogram = pointer to histogram
+//          fraction = percentile as fraction, example 0.99
+// OUTPUT:  upper bound of bucket with percentile, not above maximum, nanoseconds
+//---
+unsigned long long latencyPercentile( LATENCY_HISTOGRAM* histogram, double fraction )
+    {
+    unsigned long long sum = 0;
+    unsigned long long bound = 0;
+    int i = 0, bits = 0;
+    for ( i=0; i<LAT_BUCKETS; i++ )
+        {
+        sum += histogram->counts[i];
+        if ( ( sum > 0 )&&( sum >= ( histogram->samples * fraction ) ) ) break;
+        }
+    if ( i < LAT_SUB )
+        {
+        bound = i + 1;
+        }
+    else
+        {
+        bits = i / LAT_SUB + LAT_SUB_BITS - 1;
+        bound = (unsigned long long)( LAT_SUB + ( i % LAT_SUB ) + 1 ) << ( bits - LAT_SUB_BITS );
+        }
+    if ( bound > histogram->maximum ) { bound = histogram->maximum; }
+    return bound;
+    }
+
+//--- Handler for output latency percentiles string ---
+// INPUT:   name = string name
+//          histogram = pointer to histogram
+//---
+void printLatency( char* name, LATENCY_HISTOGRAM* histogram )
+    {
+    if ( histogram->samples == 0 )
+        {
+        printf( "       %-11sn/a\n", name );
+        return;
+        }
+    printf( "       %-11sp50 %.3f us, p90 %.3f us, p99 %.3f us, p99.9 %.3f us, max %.3f us, %llu samples\n",
+            name,
+            latencyPercentile( histogram, 0.5 ) / 1000.0,
+            latencyPercentile( histogram, 0.9 ) / 1000.0,
+            latencyPercentile( histogram, 0.99 ) / 1000.0,
+            latencyPercentile( histogram, 0.999 ) / 1000.0,
+            histogram->maximum / 1000.0,
+            histogram->samples );
+    }
+
+//--- Helper method for open performance counters group of calling thread ---
+// If kernel counting not permitted by perf_event_paranoid, user space only used,
+// counter not available skipped, group leader is first opened counter, disabled.
+// INPUT:   handles = array of PERF_EVENTS file descriptors, updated, -1 if not opened
+//          verbose = 1 means print not available counters
+// OUTPUT:  group leader file descriptor, -1 if no counters opened, update perfUserOnly
+//---
+int perfOpenGroup( int* handles, int verbose )
+    {
+    struct perf_event_attr attr;
+    int i = 0, leader = -1;
+    for ( i=0; i<PERF_EVENTS; i++ )
+        {
+        memset( &attr, 0, sizeof( attr ) );
+        attr.size = sizeof( attr );
+        attr.type = perfTypes[i];
+        attr.config = perfConfigs[i];
+        attr.disabled = ( leader < 0 );
+        attr.exclude_hv = 1;
+        attr.exclude_kernel = perfUserOnly;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        handles[i] = syscall( __NR_perf_event_open, &attr, 0, -1, leader, 0 );
+        if ( ( handles[i] < 0 )&&( ( errno == EACCES )||( errno == EPERM ) )&&( perfUserOnly == 0 ) )
+            {
+            perfUserOnly = 1;
+            attr.exclude_kernel = 1;
+            handles[i] = syscall( __NR_perf_event_open, &attr, 0, -1, leader, 0 );
+            }
+        if ( handles[i] < 0 )
+            {
+            if ( verbose ) { printf( "Performance counter %s not available ( %s )\n", perfNames[i], strerror(errno) ); }
+            continue;
+            }
+        if ( leader < 0 ) { leader = handles[i]; }
+        }
+    return leader;
+    }
+
+//--- Helper method for close performance counters group ---
+// INPUT:   handles = array of PERF_EVENTS file descriptors, -1 if not opened
+// OUTPUT:  none, handles set to -1
+//---
+void perfCloseGroup( int* handles )
+    {
+    int i = 0;
+    for ( i=0; i<PERF_EVENTS; i++ )
+        {
+        if ( handles[i] >= 0 ) { close( handles[i] ); }
+        handles[i] = -1;
+        }
+    }
+
+//--- Helper method for read performance counters group ---
+// Group disabled before read, values scaled by enabled/running time if counters multiplexed.
+// INPUT:   handles = array of PERF_EVENTS file descriptors, -1 if not opened
+//          leader = group leader file descriptor
+//          values = array of PERF_EVENTS values, updated, -1 if n/a
+//---
+void perfReadGroup( int* handles, int leader, long long* values )
+    {
+    unsigned long long data[3];  // value, time enabled, time running
+    int i = 0;
+    ioctl( leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP );
+    for ( i=0; i<PERF_EVENTS; i++ )
+        {
+        values[i] = -1;
+        if ( handles[i] < 0 ) continue;
+        if ( read( handles[i], data, sizeof( data ) ) != sizeof( data ) ) continue;
+        if ( data[2] == 0 ) continue;
+        values[i] = (long long)( (double)data[0] * data[1] / data[2] );
+        }
+    }
+
+//--- Helper method for add counters deltas to phase values ---
+// INPUT:   phase = PHASE_WRITE, PHASE_FLUSH or PHASE_READ
+//          values = array of PERF_EVENTS deltas, -1 if n/a
+// OUTPUT:  none, update perfValues[phase][]
+//---
+void perfAccumulate( int phase, long long* values )
+    {
+    int i = 0;
+    for ( i=0; i<PERF_EVENTS; i++ )
+        {
+        if ( values[i] < 0 ) continue;
+        if ( perfValues[phase][i] < 0 ) { perfValues[phase][i] = 0; }
+        perfValues[phase][i] += values[i];
+        }
+    }
+
+//--- Helper method for open main thread performance counters, at start ---
+// INPUT:   none
+// OUTPUT:  number of opened counters, update perfHandles[], perfLeader, perfUserOnly,
+//          messages output to console
+//---
+int perfOpen()
+    {
+    int i = 0, count = 0;
+    perfLeader = perfOpenGroup( perfHandles, 1 );
+    for ( i=0; i<PERF_EVENTS; i++ ) { if ( perfHandles[i] >= 0 ) count++; }
+    printf( "Performance counters: %d of %d opened%s\n", count, PERF_EVENTS,
+            perfUserOnly ? ", user space only" : "" );
+    return count;
+    }
+
+//--- Helper method for start performance counters phase, main thread part ---
+// INPUT:   phase = PHASE_WRITE, PHASE_FLUSH or PHASE_READ
+// OUTPUT:  none, phase values blanked, main thread group reset and enabled
+//---
+void perfStart( int phase )
+    {
+    int i = 0;
+    for ( i=0; i<PERF_EVENTS; i++ ) { perfValues[phase][i] = -1; }
+    if ( perfLeader < 0 ) return;
+    ioctl( perfLeader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP );
+    ioctl( perfLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+    }
+
+//--- Helper method for stop performance counters phase, main thread part ---
+// Walk threads deltas added to phase values by page walk after join.
+// INPUT:   phase = PHASE_WRITE, PHASE_FLUSH or PHASE_READ
+// OUTPUT:  none, main thread group disabled, main thread deltas added to perfValues[phase][]
+//---
+void perfStop( int phase )
+    {
+    long long values[PERF_EVENTS];
+    if ( perfLeader < 0 ) return;
+    perfReadGroup( perfHandles, perfLeader, values );
+    perfAccumulate( phase, values );
+    }
+
+//--- Helper method for print performance counters phase deltas and derived metrics ---
+// INPUT:   name = row name
+//          phase = PHASE_WRITE, PHASE_FLUSH or PHASE_READ
+// OUTPUT:  none, messages output to console
+//---
+void printCounters( char* name, int phase )
+    {
+    long long* values = perfValues[phase];
+    double pages = ( fileSize + walkStep - 1 ) / walkStep;
+    double gigabytes = fileSize / ( 1024.0 * 1024.0 * 1024.0 );
+    int i = 0;
+    if ( perfLeader < 0 ) return;
+    printf( "       %-11s", name );
+    if ( values[PERF_CYCLES] >= 0 ) { printf( "cycles/page %.1f, ", values[PERF_CYCLES] / pages ); }
+    else { printf( "cycles/page n/a, " ); }
+    if ( ( values[PERF_CYCLES] > 0 )&&( values[PERF_INSTRUCTIONS] >= 0 ) )
+        { printf( "IPC %.2f, ", (double)values[PERF_INSTRUCTIONS] / values[PERF_CYCLES] ); }
+    else { printf( "IPC n/a, " ); }
+    if ( values[PERF_DTLB] >= 0 ) { printf( "dTLB misses/GiB %.0f", values[PERF_DTLB] / gigabytes ); }
+    else { printf( "dTLB misses/GiB n/a" ); }
+    for ( i=0; i<PERF_EVENTS; i++ )
+        {
+        if ( values[i] >= 0 ) { printf( ", %s %lld", perfNames[i], values[i] ); }
+        else { printf( ", %s n/a", perfNames[i] ); }
+        }
+    printf( "\n" );
+    }
+
+//--- Helper method for build list of logical CPUs available for walk threads pinning ---
+// INPUT:   none, affinity mask of process used
+// OUTPUT:  update walkCpus[], walkCpusCount, count=0 means threads not pinned
+//---
+void detectWalkCpus()
+    {
+    cpu_set_t cpuSet;
+    int i = 0;
+    walkCpusCount = 0;
+    CPU_ZERO( &cpuSet );
+    if ( sched_getaffinity( 0, sizeof(cpuSet), &cpuSet ) != 0 )
+        {
+        return;
+        }
+    for ( i=0; ( i<CPU_SETSIZE )&&( walkCpusCount<THREADS_MAX ); i++ )
+        {
+        if ( CPU_ISSET( i, &cpuSet ) )
+            {
+            walkCpus[walkCpusCount] = i;
+            walkCpusCount++;
+            }
+        }
+    }
+
+//--- Page walk kernels, process all cache lines of page ---
+// Read kernels return XOR of data read, it used as walk result,
+// this prevents elimination of reads by compiler.
+// INPUT:   pointer = page address
+//          length = page length, bytes
+//          data = data pattern for write kernels
+//          buffer = per-thread buffer for memcpy kernels
+// OUTPUT:  data pattern for write kernels, XOR of data for read kernels
+//---
+typedef char (*KERNEL_ROUTINE)( char* pointer, size_t length, char data, char* buffer );
+
+char writeMemset( char* pointer, size_t length, char data, char* buffer )
+    {
+    memset( pointer, data, length );
+    return data;
+    }
+
+char readScalar( char* pointer, size_t length, char data, char* buffer )
+    {
+    uint64_t accumulator = 0;
+    uint64_t word = 0;
+    size_t i = 0;
+    for ( i=0; ( i + sizeof(uint64_t) )<=length; i+=sizeof(uint64_t) )
+        {
+        memcpy( &word, pointer + i, sizeof(uint64_t) );  // no aliasing violation, compiled to one load
+        accumulator ^= word;
+        }
+    for ( ; i<length; i++ ) { accumulator ^= (unsigned char)pointer[i]; }
+    accumulator ^= accumulator >> 32;
+    accumulator ^= accumulator >> 16;
+    accumulator ^= accumulator >> 8;
+    return (char)accumulator;
+    }
+
+char writeMemcpy( char* pointer, size_t length, char data, char* buffer )
+    {
+    memcpy( pointer, buffer, length );
+    return data;
+    }
+
+char readMemcpy( char* pointer, size_t length, char data, char* buffer )
+    {
+    memcpy( buffer, pointer, length );
+    return buffer[length - 1];
+    }
+
+#ifdef KERNELS_X86
+
+//--- Helper method for fold all bytes of 128-bit accumulator to one byte by XOR ---
+__attribute__((target("sse2")))
+static inline char foldSse2( __m128i accumulator )
+    {
+    uint32_t value = 0;
+    accumulator = _mm_xor_si128( accumulator, _mm_srli_si128( accumulator, 8 ) );
+    accumulator = _mm_xor_si128( accumulator, _mm_srli_si128( accumulator, 4 ) );
+    value = (uint32_t)_mm_cvtsi128_si32( accumulator );
+    value ^= value >> 16;
+    value ^= value >> 8;
+    return (char)value;
+    }
+
+__attribute__((target("sse2")))
+char writeSse2( char* pointer, size_t length, char data, char* buffer )
+    {
+    __m128i pattern = _mm_set1_epi8( data );
+    size_t i = 0;
+    for ( i=0; ( i + CACHE_LINE )<=length; i+=CACHE_LINE )
+        {
+        _mm_storeu_si128( (__m128i*)( pointer + i ), pattern );
+        _mm_storeu_si128( (__m128i*)( pointer + i + 16 ), pattern );
+        _mm_storeu_si128( (__m128i*)( pointer + i + 32 ), pattern );
+        _mm_storeu_si128( (__m128i*)( pointer + i + 48 ), pattern );
+        }
+    for ( ; i<length; i++ ) { pointer[i] = data; }
+    return data;
+    }
+
+__attribute__((target("sse2")))
+char readSse2( char* pointer, size_t length, char data, char* buffer )
+    {
+    __m128i accumulator = _mm_setzero_si128();
+    size_t i = 0;
+    for ( i=0; ( i + CACHE_LINE )<=length; i+=CACHE_LINE )
+        {
+        accumulator = _mm_xor_si128( accumulator, _mm_loadu_si128( (__m128i*)( pointer + i ) ) );
+        accumulator = _mm_xor_si128( accumulator, _mm_loadu_si128( (__m128i*)( pointer + i + 16 ) ) );
+        accumulator = _mm_xor_si128( accumulator, _mm_loadu_si128( (__m128i*)( pointer + i + 32 ) ) );
+        accumulator = _mm_xor_si128( accumulator, _mm_loadu_si128( (__m128i*)( pointer + i + 48 ) ) );
+        }
+    for ( ; i<length; i++ ) { data ^= pointer[i]; }
+    return data ^ foldSse2( accumulator );
+    }
+
+__attribute__((target("avx2")))
+char writeAvx2( char* pointer, size_t length, char data, char* buffer )
+    {
+    __m256i pattern = _mm256_set1_epi8( data );
+    size_t i = 0;
+    for ( i=0; ( i + CACHE_LINE )<=length; i+=CACHE_LINE )
+        {
+        _mm256_storeu_si256( (__m256i*)( pointer + i ), pattern );
+        _mm256_storeu_si256( (__m256i*)( pointer + i + 32 ), pattern );
+        }
+    for ( ; i<length; i++ ) { pointer[i] = data; }
+    return data;
+    }
+
+__attribute__((target("avx2")))
+char readAvx2( char* pointer, size_t length, char data, char* buffer )
+    {
+    __m256i accumulator = _mm256_setzero_si256();
+    size_t i = 0;
+    for ( i=0; ( i + CACHE_LINE )<=length; i+=CACHE_LINE )
+        {
+        accumulator = _mm256_xor_si256( accumulator, _mm256_loadu_si256( (__m256i*)( pointer + i ) ) );
+        accumulator = _mm256_xor_si256( accumulator, _mm256_loadu_si256( (__m256i*)( pointer + i + 32 ) ) );
+        }
+    for ( ; i<length; i++ ) { data ^= pointer[i]; }
+    return data ^ foldSse2( _mm_xor_si128( _mm256_castsi256_si128( accumulator ),
+                                           _mm256_extracti128_si256( accumulator, 1 ) ) );
+    }
+
+__attribute__((target("avx512f")))
+char writeAvx512( char* pointer, size_t length, char data, char* buffer )
+    {
+    __m512i pattern = _mm512_set1_epi32( (unsigned char)data * 0x01010101 );
+    size_t i = 0;
+    for ( i=0; ( i + CACHE_LINE )<=length; i+=CACHE_LINE )
+        {
+        _mm512_storeu_si512( (void*)( pointer + i ), pattern );
+        }
+    for ( ; i<length; i++ ) { pointer[i] = data; }
+    return data;
+    }
+
+__attribute__((target("avx512f")))
+char readAvx512( char* pointer, size_t length, char data, char* buffer )
+    {
+    __m512i accumulator = _mm512_setzero_si512();
+    __m256i half;
+    size_t i = 0;
+    for ( i=0; ( i + CACHE_LINE )<=length; i+=CACHE_LINE )
+        {
+        accumulator = _mm512_xor_si512( accumulator, _mm512_loadu_si512( (void*)( pointer + i ) ) );
+        }
+    for ( ; i<length; i++ ) { data ^= pointer[i]; }
+    half = _mm256_xor_si256( _mm512_castsi512_si256( accumulator ),
+                                     _mm512_extracti64x4_epi64( accumulator, 1 ) );
+    return data ^ foldSse2( _mm_xor_si128( _mm256_castsi256_si128( half ), _mm256_extracti128_si256( half, 1 ) ) );
+    }
+
+__attribute__((target("sse2")))
+char writeNt( char* pointer, size_t length, char data, char* buffer )
+    {
+    __m128i pattern = _mm_set1_epi8( data );
+    size_t i = 0;
+    for ( i=0; ( i + CACHE_LINE )<=length; i+=CACHE_LINE )
+        {
+        _mm_stream_si128( (__m128i*)( pointer + i ), pattern );
+        _mm_stream_si128( (__m128i*)( pointer + i + 16 ), pattern );
+        _mm_stream_si128( (__m128i*)( pointer + i + 32 ), pattern );
+        _mm_stream_si128( (__m128i*)( pointer + i + 48 ), pattern );
+        }
+    for ( ; i<length; i++ ) { pointer[i] = data; }
+    _mm_sfence();
+    return data;
+    }
+
+__attribute__((target("sse4.1")))
+char readNt( char* pointer, size_t length, char data, char* buffer )
+    {
+    __m128i accumulator = _mm_setzero_si128();
+    size_t i = 0;
+    for ( i=0; ( i + CACHE_LINE )<=length; i+=CACHE_LINE )
+        {
+        accumulator = _mm_xor_si128( accumulator, _mm_stream_load_si128( (__m128i*)( pointer + i ) ) );
+        accumulator = _mm_xor_si128( accumulator, _mm_stream_load_si128( (__m128i*)( pointer + i + 16 ) ) );
+        accumulator = _mm_xor_si128( accumulator, _mm_stream_load_si128( (__m128i*)( pointer + i + 32 ) ) );
+        accumulator = _mm_xor_si128( accumulator, _mm_stream_load_si128( (__m128i*)( pointer + i + 48 ) ) );
+        }
+    for ( ; i<length; i++ ) { data ^= pointer[i]; }
+    return data ^ foldSse2( accumulator );
+    }
+
+#endif
+
+//--- Helper method for select page walk kernels by kernel mode and CPUID ---
+// INPUT:   kernelMode = selected kernel, auto means best SIMD kernel supported by CPU
+// OUTPUT:  status, 0=kernel supported, 1=not supported by CPU or build
+//          update kernelMode if auto, kernelWrite, kernelRead
+//---
+int selectKernel()
+    {
+#ifdef KERNELS_X86
+    __builtin_cpu_init();
+    if ( kernelMode == KERNEL_AUTO )
+        {
+        kernelMode = KERNEL_MEMSET;
+        if ( __builtin_cpu_supports( "sse2" ) )    { kernelMode = KERNEL_SSE2; }
+        if ( __builtin_cpu_supports( "avx2" ) )    { kernelMode = KERNEL_AVX2; }
+        if ( __builtin_cpu_supports( "avx512f" ) ) { kernelMode = KERNEL_AVX512; }
+        }
+#else
+    if ( kernelMode == KERNEL_AUTO ) { kernelMode = KERNEL_MEMSET; }
+#endif
+    kernelWrite = NULL;
+    kernelRead = NULL;
+    switch ( kernelMode )
+        {
+        case KERNEL_MEMSET:
+            kernelWrite = writeMemset;
+            kernelRead = readScalar;
+            break;
+        case KERNEL_MEMCPY:
+            kernelWrite = writeMemcpy;
+            kernelRead = readMemcpy;
+            break;
+#ifdef KERNELS_X86
+        case KERNEL_SSE2:
+            if ( !__builtin_cpu_supports( "sse2" ) ) return 1;
+            kernelWrite = writeSse2;
+            kernelRead = readSse2;
+            break;
+        case KERNEL_AVX2:
+            if ( !__builtin_cpu_supports( "avx2" ) ) return 1;
+            kernelWrite = writeAvx2;
+            kernelRead = readAvx2;
+            break;
+        case KERNEL_AVX512:
+            if ( !__builtin_cpu_supports( "avx512f" ) ) return 1;
+            kernelWrite = writeAvx512;
+            kernelRead = readAvx512;
+            break;
+        case KERNEL_NT:
+            if ( !__builtin_cpu_supports( "sse4.1" ) ) return 1;
+            kernelWrite = writeNt;
+            kernelRead = readNt;
+            break;
+#endif
+        case KERNEL_TOUCH:
+            break;
+        default:
+            return 1;
+        }
+    return 0;
+    }
+
+//--- Helper method for calculate greatest common divisor ---
+// INPUT:   a, b = values
+// OUTPUT:  greatest common divisor of a and b
+//---
+size_t greatestCommonDivisor( size_t a, size_t b )
+    {
+    size_t t = 0;
+    while ( b != 0 )
+        {
+        t = a % b;
+        a = b;
+        b = t;
+        }
+    return a;
+    }
+
+//--- Helper method for set addressing parameters of walk thread partition ---
+// INPUT:   context = thread context, length and index must be set
+// OUTPUT:  update pages, seed, mask, shift, stridePages of thread context
+//---
+void setAddressing( WALK_CONTEXT* context )
+    {
+    int bits = 0;
+    context->pages = ( context->length + walkStep - 1 ) / walkStep;
+    context->seed = (uint64_t)walkSeed * 0x9E3779B97F4A7C15ULL + context->index;
+    context->mask = 0;
+    while ( context->mask < ( context->pages - 1 ) )
+        {
+        context->mask = ( context->mask << 1 ) | 1;
+        bits++;
+        }
+    context->shift = ( bits + 1 ) / 2;
+    if ( context->shift == 0 ) { context->shift = 1; }
+    context->stridePages = STRIDED_PAGES;
+    while ( ( context->pages > 1 )&&
+            ( greatestCommonDivisor( context->stridePages, context->pages ) != 1 ) )
+        {
+        context->stridePages++;
+        }
+    }
+
+//--- Helper method for get next page index by addressing mode ---
+// Random addressing is bijective mixing of N-bit counter, values outside
+// of partition skipped (cycle walking), each page visited exactly once,
+// no lookup table required. Strided addressing visits pages by stride,
+// coprime with number of pages, also each page exactly once.
+// INPUT:   context = thread context with addressing parameters
+//          counter = pointer to permutation counter, updated
+// OUTPUT:  page index in thread partition
+//---
+static inline size_t nextPageIndex( WALK_CONTEXT* context, uint64_t* counter )
+    {
+    uint64_t x = 0;
+    switch ( addressing )
+        {
+        case ADDR_REVERSE:
+            {
+            x = context->pages - 1 - *counter;
+            ( *counter )++;
+            break;
+            }
+        case ADDR_STRIDED:
+            {
+            x = ( *counter * context->stridePages ) % context->pages;
+            ( *counter )++;
+            break;
+            }
+        case ADDR_RANDOM:
+            {
+            do  {
+                x = ( *counter + context->seed ) & context->mask;
+                x ^= x >> context->shift;
+                x = ( x * 0xBF58476D1CE4E5B9ULL ) & context->mask;
+                x ^= x >> context->shift;
+                x = ( x * 0x94D049BB133111EBULL ) & context->mask;
+                x ^= x >> context->shift;
+                ( *counter )++;
+                } while ( x >= context->pages );
+            break;
+            }
+        default:
+            {
+            x = *counter;
+            ( *counter )++;
+            break;
+            }
+        }
+    return x;
+    }
+
+//--- Helper method for publish write walk progress to flusher thread ---
+// INPUT:   progress = bytes dirtied from mapping start
+//          done = 1 if walk done, 0 if walk continues
+//---
+void behindPublish( size_t progress, int done )
+    {
+    pthread_mutex_lock( &behindMutex );
+    behindProgress = progress;
+    behindDone = done;
+    pthread_cond_signal( &behindCond );
+    pthread_mutex_unlock( &behindMutex );
+    }
+
+//--- Write-behind page walk: sequential, each page write timed, progress published per chunk ---
+// INPUT:   context = thread context, single thread partition is whole mapping
+// OUTPUT:  update thread latency histogram, stallCount
+//---
+void behindWalk( WALK_CONTEXT* context )
+    {
+    volatile char* walkPointer = context->base;
+    size_t offset = 0, length = 0, published = 0;
+    unsigned long long ns1 = 0, ns2 = 0;
+    for ( offset=0; offset<context->length; offset+=walkStep )
+        {
+        length = context->length - offset;
+        if ( length > walkStep ) { length = walkStep; }
+        ns1 = readNanoseconds();
+        if ( kernelWrite != NULL )
+            {
+            kernelWrite( context->base + offset, length, context->data, context->buffer );
+            }
+        else
+            {
+            walkPointer[offset] = context->data;
+            }
+        ns2 = readNanoseconds();
+        //--- Page write time to histogram, stall if above threshold ---
+        latencyAdd( context->histogram, intervalNanoseconds( ns1, ns2 ) );
+        if ( ( ns2 - ns1 ) > STALL_THRESHOLD ) { stallCount++; }
+        //--- Chunk dirtied, flusher can start write-out of it ---
+        if ( ( offset + length ) >= ( published + writeBehind ) )
+            {
+            published = offset + length;
+            behindPublish( published, 0 );
+            }
+        }
+    behindPublish( context->length, 1 );
+    }
+
+//--- Timed page walk: each or every N-th walk step timed, any addressing and kernel ---
+// INPUT:   context = thread context
+// OUTPUT:  update thread latency histogram, walk data
+//---
+void latencyWalk( WALK_CONTEXT* context )
+    {
+    volatile char* walkPointer = context->base;   // volatile prevents read walk elimination
+    char walkData = context->data;
+    uint64_t counter = 0;
+    size_t i = 0;
+    size_t offset = 0, length = 0;
+    unsigned long long ns1 = 0, ns2 = 0;
+    int countdown = 1;
+    for ( i=0; i<context->pages; i++ )
+        {
+        offset = nextPageIndex( context, &counter ) * walkStep;
+        length = context->length - offset;
+        if ( length > walkStep ) { length = walkStep; }
+        countdown--;
+        if ( countdown == 0 ) { ns1 = readNanoseconds(); }
+        if ( context->operation == WALK_WRITE )
+            {
+            if ( kernelWrite != NULL ) { kernelWrite( context->base + offset, length, walkData, context->buffer ); }
+            else { walkPointer[offset] = walkData; }
+            }
+        else
+            {
+            if ( kernelRead != NULL ) { walkData ^= kernelRead( context->base + offset, length, 0, context->buffer ); }
+            else { walkData ^= walkPointer[offset]; }
+            }
+        if ( countdown == 0 )
+            {
+            ns2 = readNanoseconds();
+            latencyAdd( context->histogram, intervalNanoseconds( ns1, ns2 ) );
+            countdown = latencyStep;
+            }
+        }
+    context->data = walkData;
+    }
+
+//--- Helper method for set mixed walk access distribution parameters ---
+// Zipf generator by Gray et al. (quick generation of billion-record databases), normalization
+// zeta( pages, theta ) summed for first ZIPF_EXACT ranks and integral approximation for rest.
+// Popularity rank mapped to page by multiplier coprime with pages, hot pages spread over file.
+// INPUT:   pages = number of pages in mapping
+//          distribution, skew
+// OUTPUT:  update mixPages, mixHotPages, mixScramble, zipf parameters
+//---
+void setDistribution( size_t pages )
+    {
+    double theta = skew / 100.0;
+    double zeta = 0.0;
+    size_t exact = pages < ZIPF_EXACT ? pages : ZIPF_EXACT;
+    size_t i = 0;
+    mixPages = pages;
+    for ( i=1; i<=exact; i++ ) { zeta += pow( (double)i, -theta ); }
+    if ( pages > exact )
+        {
+        zeta += ( pow( pages + 0.5, 1.0 - theta ) - pow( exact + 0.5, 1.0 - theta ) ) / ( 1.0 - theta );
+        }
+    zipfZetan = zeta;
+    zipfAlpha = 1.0 / ( 1.0 - theta );
+    zipfHalf = pow( 0.5, theta );
+    zipfEta = 0.0;
+    if ( pages > 1 )
+        {
+        zipfEta = ( 1.0 - pow( 2.0 / pages, 1.0 - theta ) ) / ( 1.0 - ( 1.0 + zipfHalf ) / zeta );
+        }
+    mixHotPages = pages * ( 100 - skew ) / 100;
+    if ( mixHotPages == 0 ) { mixHotPages = 1; }
+    mixScramble = ( pages > 1 ) ? ( MIX_SCRAMBLE % pages ) : 1;
+    if ( mixScramble == 0 ) { mixScramble = 1; }
+    while ( greatestCommonDivisor( mixScramble, pages ) != 1 ) { mixScramble++; }
+    }
+
+//--- Helper method for get next random number, xorshift64 ---
+static inline uint64_t nextRandom( uint64_t* random )
+    {
+    *random ^= *random << 13;
+    *random ^= *random >> 7;
+    *random ^= *random << 17;
+    return *random;
+    }
+
+//--- Helper method for get next page index of mixed walk by access distribution ---
+// INPUT:   random = pointer to thread random generator state, updated
+//          distribution, mixPages and distribution parameters
+// OUTPUT:  page index in whole mapping
+//---
+static inline size_t nextMixedPage( uint64_t* random )
+    {
+    double u = 0.0, uz = 0.0;
+    uint64_t rank = 0;
+    if ( mixPages < 2 ) return 0;
+    switch ( distribution )
+        {
+        case DIST_ZIPF:
+            {
+            u = ( nextRandom( random ) >> 11 ) * ( 1.0 / 9007199254740992.0 );
+            uz = u * zipfZetan;
+            if ( uz < 1.0 ) { rank = 0; }
+            else if ( uz < ( 1.0 + zipfHalf ) ) { rank = 1; }
+            else { rank = mixPages * pow( zipfEta * u - zipfEta + 1.0, zipfAlpha ); }
+            if ( rank >= mixPages ) { rank = mixPages - 1; }
+            return ( rank * mixScramble ) % mixPages;
+            }
+        case DIST_HOTSPOT:
+            {
+            if ( ( ( ( nextRandom( random ) >> 33 ) % 100 ) < (uint64_t)skew )||( mixHotPages >= mixPages ) )
+                {
+                rank = ( nextRandom( random ) >> 11 ) % mixHotPages;
+                }
+            else
+                {   // cold accesses to cold pages only, hot set gets exactly skew percents
+                rank = mixHotPages + ( nextRandom( random ) >> 11 ) % ( mixPages - mixHotPages );
+                }
+            return ( rank * mixScramble ) % mixPages;
+            }
+        default:
+            {
+            return ( nextRandom( random ) >> 11 ) % mixPages;
+            }
+        }
+    }
+
+//--- Mixed walk: reads and writes interleaved on same mapping, each access timed ---
+// Access type selected by rwmix reads percentage, page by access distribution over whole
+// mapping, all threads share mapping, number of accesses is thread partition pages.
+// INPUT:   context = thread context, base is start of mapping
+// OUTPUT:  update context mixHistograms[], mixOps[], mixNanoseconds[], data
+//---
+void mixedWalk( WALK_CONTEXT* context )
+    {
+    volatile char* walkPointer = context->base;   // volatile prevents read walk elimination
+    char walkData = context->data;
+    uint64_t random = context->seed | 1;
+    size_t i = 0;
+    size_t offset = 0, length = 0;
+    unsigned long long ns1 = 0, ns2 = 0, ns = 0;
+    int type = WALK_WRITE;
+    for ( i=0; i<context->pages; i++ )
+        {
+        type = ( ( ( nextRandom( &random ) >> 33 ) % 100 ) < (uint64_t)rwmix ) ? WALK_READ : WALK_WRITE;
+        offset = nextMixedPage( &random ) * walkStep;
+        length = mapLength - offset;
+        if ( length > walkStep ) { length = walkStep; }
+        ns1 = readNanoseconds();
+        if ( type == WALK_WRITE )
+            {
+            if ( kernelWrite != NULL ) { kernelWrite( context->base + offset, length, walkData, context->buffer ); }
+            else { walkPointer[offset] = walkData; }
+            }
+        else
+            {
+            if ( kernelRead != NULL ) { walkData ^= kernelRead( context->base + offset, length, 0, context->buffer ); }
+            else { walkData ^= walkPointer[offset]; }
+            }
+        ns2 = readNanoseconds();
+        ns = intervalNanoseconds( ns1, ns2 );
+        latencyAdd( context->mixHistograms[type], ns );
+        context->mixOps[type]++;
+        context->mixNanoseconds[type] += ns;
+        }
+    context->data = walkData;
+    }
+
+//--- Write-behind flusher thread: start write-out of chunks already dirtied by walk ---
+// msync() of chunk for msync modes, otherwise sync_file_range() start write-out of
+// chunk and wait write-out of previous chunk, flusher stays one chunk behind the walk.
+// INPUT:   arg = not used, current mapping used
+// OUTPUT:  NULL, update behindStatus, behindChunks, behindSeconds
+//---
+void* behindThreadRoutine( void* arg )
+    {
+    struct timespec tsFlush1, tsFlush2;
+    size_t flushed = 0, ready = 0, length = 0;
+    size_t previous = 0;
+    int done = 0;
+    int flushStatus = 0;
+    while ( ( done == 0 )||( flushed < ready ) )
+        {
+        //--- Wait for next dirtied chunk or walk done ---
+        pthread_mutex_lock( &behindMutex );
+        while ( ( behindProgress < ( flushed + writeBehind ) )&&( behindDone == 0 ) )
+            {
+            pthread_cond_wait( &behindCond, &behindMutex );
+            }
+        ready = behindProgress;
+        done = behindDone;
+        pthread_mutex_unlock( &behindMutex );
+        //--- Flush all complete chunks, and tail if walk done ---
+        while ( ( ( ready - flushed ) >= writeBehind )||( ( done != 0 )&&( flushed < ready ) ) )
+            {
+            length = ready - flushed;
+            if ( length > writeBehind ) { length = writeBehind; }
+            readTime( &tsFlush1 );
+            if ( ( wsyncMode == WSYNC_MSYNC )|( wsyncMode == WSYNC_MSYNC_ASYNC ) )
+                {
+                flushStatus = msync( (char*)mapPointer + flushed, length, wsyncValues[wsyncMode] );
+                }
+            else
+                {
+                flushStatus = sync_file_range( fileHandle, mapOffset + flushed, length, SYNC_FILE_RANGE_WRITE );
+                if ( ( flushStatus == 0 )&&( flushed > 0 ) )
+                    {
+                    flushStatus = sync_file_range( fileHandle, mapOffset + previous, flushed - previous,
+                        SYNC_FILE_RANGE_WAIT_BEFORE|SYNC_FILE_RANGE_WRITE|SYNC_FILE_RANGE_WAIT_AFTER );
+                    }
+                }
+            readTime( &tsFlush2 );
+            if ( flushStatus < 0 )
+                {
+                behindStatus = errno;
+                return NULL;
+                }
+            behindSeconds += secondsDelta( &tsFlush1, &tsFlush2 );
+            behindChunks++;
+            previous = flushed;
+            flushed += length;
+            }
+        }
+    return NULL;
+    }
+
+//--- Handler for output write-behind strings at test progress, if write-behind used ---
+// INPUT:   none, results of last write walk and total time of last write pass used
+//---
+void printWriteBehind()
+    {
+    if ( writeBehind == 0 ) return;
+    printf( "       behind     %d chunks, flusher busy %.3f ms, time to durable %.3f ms\n",
+            behindChunks, behindSeconds * 1000.0, seconds * 1000.0 );
+    printLatency( "stalls", &passLatency );
+    printf( "       %-11s%llu of %llu page writes above %d us\n", "", stallCount, passLatency.samples,
+            STALL_THRESHOLD / 1000 );
+    }
+
+//--- Page walk of one thread range, current partition of mapping or window ---
+// INPUT:   context = pointer to WALK_CONTEXT of this thread
+// OUTPUT:  none, results stored to WALK_CONTEXT
+//---
+void walkRange( WALK_CONTEXT* context )
+    {
+    volatile char* walkPointer = context->base;   // volatile prevents read walk elimination
+    size_t walkLength = 0;
+    char walkData = context->data;
+    uint64_t counter = 0;
+    size_t i = 0;
+    size_t offset = 0, length = 0;
+    struct timespec tsStart, tsStop;
+    readTime( &tsStart );
+    //--- Buffer page walk, this thread partition only, or mixed walk of whole mapping ---
+    if ( context->operation == WALK_MIXED )
+        {
+        mixedWalk( context );
+        }
+    else if ( ( writeBehind != 0 )&&( context->operation == WALK_WRITE ) )
+        {
+        behindWalk( context );
+        }
+    else if ( latencyStep != 0 )
+        {
+        latencyWalk( context );
+        }
+    else if ( ( kernelWrite != NULL )&&( context->operation == WALK_WRITE ) )
+        {
+        for ( i=0; i<context->pages; i++ )
+            {
+            offset = nextPageIndex( context, &counter ) * walkStep;
+            length = context->length - offset;
+            if ( length > walkStep ) { length = walkStep; }
+            kernelWrite( context->base + offset, length, walkData, context->buffer );
+            }
+        }
+    else if ( kernelRead != NULL )
+        {
+        for ( i=0; i<context->pages; i++ )
+            {
+            offset = nextPageIndex( context, &counter ) * walkStep;
+            length = context->length - offset;
+            if ( length > walkStep ) { length = walkStep; }
+            walkData ^= kernelRead( context->base + offset, length, 0, context->buffer );
+            }
+        }
+    else if ( ( addressing == ADDR_SEQUENTIAL )&&( context->operation == WALK_WRITE ) )
+        {
+        while ( walkLength < context->length )
+            {
+            *walkPointer = walkData;
+            walkPointer += walkStep;
+            walkLength += walkStep;
+            }
+        }
+    else if ( addressing == ADDR_SEQUENTIAL )
+        {
+        while ( walkLength < context->length )
+            {
+            walkData = *walkPointer;
+            walkPointer += walkStep;
+            walkLength += walkStep;
+            }
+        }
+    else if ( context->operation == WALK_WRITE )
+        {
+        for ( i=0; i<context->pages; i++ )
+            {
+            walkPointer = context->base + nextPageIndex( context, &counter ) * walkStep;
+            *walkPointer = walkData;
+            }
+        }
+    else
+        {
+        for ( i=0; i<context->pages; i++ )
+            {
+            walkPointer = context->base + nextPageIndex( context, &counter ) * walkStep;
+            walkData = *walkPointer;
+            }
+        }
+    readTime( &tsStop );
+    //--- Store this thread results ---
+    context->data = walkData;
+    context->seconds = secondsDelta( &tsStart, &tsStop );
+    context->mbps = 0.0;
+    if ( context->seconds > 0.0 )
+        {
+        context->mbps = context->length / 1048576.0 / context->seconds;
+        }
+    }
+
+//--- Page walk thread routine: pin to CPU, wait common start, walk own partition ---
+// Thread reused by window walk: after each range it waits common stop, then next range or quit.
+// Performance counters enabled for walk only, values are totals of all ranges.
+// INPUT:   arg = pointer to WALK_CONTEXT of this thread
+// OUTPUT:  NULL, results stored to WALK_CONTEXT
+//---
+void* walkThread( void* arg )
+    {
+    WALK_CONTEXT* context = (WALK_CONTEXT*) arg;
+    cpu_set_t cpuSet;
+    int perfThread[PERF_EVENTS];
+    int perfThreadLeader = -1;
+    int i = 0;
+    //--- Pin thread to CPU, walk continues unpinned if this failed ---
+    if ( context->cpu >= 0 )
+        {
+        CPU_ZERO( &cpuSet );
+        CPU_SET( context->cpu, &cpuSet );
+        if ( pthread_setaffinity_np( pthread_self(), sizeof(cpuSet), &cpuSet ) != 0 )
+            {
+            context->cpu = -1;
+            }
+        }
+    //--- Open this thread performance counters, if main thread counters opened ---
+    for ( i=0; i<PERF_EVENTS; i++ ) { context->counters[i] = -1; perfThread[i] = -1; }
+    if ( perfLeader >= 0 ) { perfThreadLeader = perfOpenGroup( perfThread, 0 ); }
+    for ( ; ; )
+        {
+        //--- Wait for all threads and main thread ready ---
+        pthread_barrier_wait( &walkBarrier );
+        if ( walkQuit ) break;
+        if ( perfThreadLeader >= 0 ) { ioctl( perfThreadLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP ); }
+        walkRange( context );
+        if ( perfThreadLeader >= 0 ) { perfReadGroup( perfThread, perfThreadLeader, context->counters ); }
+        if ( !walkReuse ) break;
+        pthread_barrier_wait( &walkDoneBarrier );
+        }
+    if ( perfThreadLeader >= 0 ) { perfCloseGroup( perfThread ); }
+    return NULL;
+    }
+
+//--- Helper method for get bytes accessed by one walk step ---
+// Touch kernel with stride above page size touches one page per step, pages between
+// steps not accessed, full-page kernels access whole step.
+// INPUT:   none, walkStep, kernelMode and page mode used
+// OUTPUT:  bytes accessed per walk step
+//---
+size_t stepBytes()
+    {
+    size_t page = ( ( pageMode == PAGES_HUGETLB )&&( hugePageSize > 0 ) ) ? hugePageSize : pageSize;
+    if ( ( kernelMode == KERNEL_TOUCH )&&( walkStep > page ) ) return page;
+    return walkStep;
+    }
+
+//--- Helper method for get bytes accessed by walk of range ---
+// INPUT:   length = walked range length, bytes
+// OUTPUT:  bytes accessed, walk steps multiplied by bytes per step, not above length
+//---
+long long touchedBytes( long long length )
+    {
+    long long bytes = 0;
+    if ( stepBytes() == walkStep ) return length;
+    bytes = ( ( length + walkStep - 1 ) / walkStep ) * stepBytes();
+    return bytes < length ? bytes : length;
+    }
+
+//--- Helper method for set walk threads ranges, current mapping partitioned to equal page-aligned ranges ---
+// Mixed walk threads use whole mapping.
+// INPUT:   operation = WALK_WRITE, WALK_READ or WALK_MIXED
+//          mapPointer, mapLength = current mapping
+// OUTPUT:  update base, length and addressing of walk contexts
+//---
+void setWalkRanges( int operation )
+    {
+    size_t pages = ( mapLength + walkStep - 1 ) / walkStep;
+    size_t offset = 0;
+    size_t count = 0;
+    int i = 0;
+    for ( i=0; i<threads; i++ )
+        {
+        count = pages / threads;
+        if ( i < ( pages % threads ) ) { count++; }
+        count *= walkStep;
+        if ( count > ( mapLength - offset ) ) { count = mapLength - offset; }
+        walkContexts[i].base = (char*)mapPointer + offset;
+        if ( operation == WALK_MIXED ) { walkContexts[i].base = (char*)mapPointer; }
+        walkContexts[i].length = count;
+        walkContexts[i].seconds = 0.0;
+        walkContexts[i].mbps = 0.0;
+        setAddressing( &walkContexts[i] );
+        offset += count;
+        }
+    }
+
+//--- Helper method for create walk threads, each waits at barrier for range release ---
+// INPUT:   operation = WALK_WRITE, WALK_READ or WALK_MIXED
+//          data = data pattern for write
+//          walkReuse = 1 means threads reused for many ranges (windows)
+// OUTPUT:  status, 0=threads created OK, otherwise error, messages output to console
+//---
+int startWalkThreads( int operation, char data )
+    {
+    int i = 0, j = 0;
+    walkQuit = 0;
+    status = pthread_barrier_init( &walkBarrier, NULL, threads + 1 );
+    if ( status == 0 ) { status = pthread_barrier_init( &walkDoneBarrier, NULL, threads + 1 ); }
+    if ( status != 0 )
+        {
+        printf( "\nBarrier create error ( %s )\n", strerror(status) );
+        return 3;
+        }
+    //--- Create threads, each waits at barrier ---
+    for ( i=0; i<threads; i++ )
+        {
+        walkContexts[i].index = i;
+        walkContexts[i].cpu = -1;
+        if ( walkCpusCount > 0 ) { walkContexts[i].cpu = walkCpus[ i % walkCpusCount ]; }
+        walkContexts[i].operation = operation;
+        walkContexts[i].data = data;
+        walkContexts[i].buffer = NULL;
+        if ( kernelMode == KERNEL_MEMCPY )
+            {
+            walkContexts[i].buffer = memalign( bufAlign, walkStep );
+            if ( walkContexts[i].buffer == NULL )
+                {
+                printf( "%s ( %s )\n", "Memory allocation failed", strerror(errno) );
+                return 3;
+                }
+            memset( walkContexts[i].buffer, data, walkStep );
+            }
+        for ( j=0; j<2; j++ )
+            {
+            walkContexts[i].mixHistograms[j] = NULL;
+            walkContexts[i].mixOps[j] = 0;
+            walkContexts[i].mixNanoseconds[j] = 0;
+            if ( operation != WALK_MIXED ) continue;
+            walkContexts[i].mixHistograms[j] = calloc( 1, sizeof( LATENCY_HISTOGRAM ) );
+            if ( walkContexts[i].mixHistograms[j] == NULL )
+                {
+                printf( "%s ( %s )\n", "Memory allocation failed", strerror(errno) );
+                return 3;
+                }
+            }
+        walkContexts[i].histogram = NULL;
+        if ( ( latencyStep != 0 )||( ( writeBehind != 0 )&&( operation == WALK_WRITE ) ) )
+            {
+            walkContexts[i].histogram = calloc( 1, sizeof( LATENCY_HISTOGRAM ) );
+            if ( walkContexts[i].histogram == NULL )
+                {
+                printf( "%s ( %s )\n", "Memory allocation failed", strerror(errno) );
+                return 3;
+                }
+            }
+        status = pthread_create( &walkContexts[i].thread, NULL, walkThread, &walkContexts[i] );
+        if ( status != 0 )
+            {
+            printf( "\nThread create error ( %s )\n", strerror(status) );
+            return 3;
+            }
+        }
+    //--- Create write-behind flusher thread, it waits for first dirtied chunk ---
+    if ( ( writeBehind != 0 )&&( operation == WALK_WRITE ) )
+        {
+        behindProgress = 0;
+        behindDone = 0;
+        behindStatus = 0;
+        behindChunks = 0;
+        behindSeconds = 0.0;
+        stallCount = 0;
+        status = pthread_create( &behindThread, NULL, behindThreadRoutine, NULL );
+        if ( status != 0 )
+            {
+            printf( "\nThread create error ( %s )\n", strerror(status) );
+            return 3;
+            }
+        }
+    return 0;
+    }
+
+//--- Helper method for release walk threads to walk ranges, time measurement start point ---
+// INPUT:   none, ranges set by setWalkRanges()
+// OUTPUT:  status, 0=released OK, otherwise error, messages output to console
+//          ts1 = time measurement start point, when all threads released
+//---
+int releaseWalkThreads()
+    {
+    pthread_barrier_wait( &walkBarrier );
+    status = readTime( &ts1 );
+    if( status != 0 )
+        {
+        printf( "\nGet time error ( %s )\n", strerror(errno) );
+        return 3;
+        }
+    return 0;
+    }
+
+//--- Helper method for wait walk threads done and release their resources ---
+// Reused threads released once more with walkQuit set, they exit without walk.
+// INPUT:   operation = WALK_WRITE, WALK_READ or WALK_MIXED
+// OUTPUT:  status, 0=threads done OK, otherwise error, messages output to console
+//          threads latency histograms merged to passLatency, if timed walk
+//          mixLatency[], mixOps[], mixMbps[] for mixed walk
+//          threads performance counters deltas added to phase values
+//---
+int joinWalkThreads( int operation )
+    {
+    int i = 0, j = 0;
+    if ( walkReuse )
+        {
+        walkQuit = 1;
+        pthread_barrier_wait( &walkBarrier );
+        }
+    //--- Wait all threads done ---
+    for ( i=0; i<threads; i++ )
+        {
+        status = pthread_join( walkContexts[i].thread, NULL );
+        if ( status != 0 )
+            {
+            printf( "\nThread join error ( %s )\n", strerror(status) );
+            return 3;
+            }
+        free( walkContexts[i].buffer );
+        if ( walkContexts[i].histogram != NULL )
+            {
+            latencyMerge( &passLatency, walkContexts[i].histogram );
+            free( walkContexts[i].histogram );
+            }
+        for ( j=0; ( operation == WALK_MIXED )&&( j<2 ); j++ )
+            {
+            latencyMerge( &mixLatency[j], walkContexts[i].mixHistograms[j] );
+            free( walkContexts[i].mixHistograms[j] );
+            mixOps[j] += walkContexts[i].mixOps[j];
+            if ( walkContexts[i].mixNanoseconds[j] > 0 )
+                {
+                mixMbps[j] += walkContexts[i].mixOps[j] * stepBytes() / 1048576.0 /
+                              ( walkContexts[i].mixNanoseconds[j] * TIME_TO_SECONDS );
+                }
+            }
+        perfAccumulate( operation == WALK_WRITE ? PHASE_WRITE : PHASE_READ, walkContexts[i].counters );
+        }
+    //--- Wait flusher thread done, it flushes tail after walk done ---
+    if ( ( writeBehind != 0 )&&( operation == WALK_WRITE ) )
+        {
+        status = pthread_join( behindThread, NULL );
+        if ( status != 0 )
+            {
+            printf( "\nThread join error ( %s )\n", strerror(status) );
+            return 3;
+            }
+        if ( behindStatus != 0 )
+            {
+            printf ( "\nWrite-behind flush error: %s ( %s )\n", filePath, strerror(behindStatus) );
+            return 3;
+            }
+        }
+    pthread_barrier_destroy( &walkBarrier );
+    pthread_barrier_destroy( &walkDoneBarrier );
+    return 0;
+    }
+
+//--- Run page walk by threads, mapping partitioned to equal page-aligned ranges ---
+// INPUT:   operation = WALK_WRITE or WALK_READ
+//          data = data pattern for write
+// OUTPUT:  status, 0=walk OK, otherwise error, messages output to console
+//          ts1 = time measurement start point, when all threads released
+//          threads latency histograms merged to passLatency, if timed walk
+//          mixLatency[], mixOps[], mixMbps[] for mixed walk
+//          threads performance counters deltas added to phase values
+//---
+int pageWalk( int operation, char data )
+    {
+    int j = 0;
+    if ( operation == WALK_MIXED )
+        {
+        setDistribution( ( mapLength + walkStep - 1 ) / walkStep );
+        for ( j=0; j<2; j++ )
+            {
+            latencyClear( &mixLatency[j] );
+            mixOps[j] = 0;
+            mixMbps[j] = 0.0;
+            }
+        }
+    walkReuse = 0;
+    setWalkRanges( operation );
+    status = startWalkThreads( operation, data );
+    if ( status != 0 ) return status;
+    status = releaseWalkThreads();
+    if ( status != 0 ) return status;
+    return joinWalkThreads( operation );
+    }
+
+//--- Handler for output statistics as pages per second, IOPS equivalent ---
+// INPUT:   none, last calculated statistics in megabytes per second used
+//---
+void printPagesRate()
+    {
+    double pagesPerMegabyte = 1048576.0 / stepBytes();
+    printf( "Walk steps (pages) per second (median, average, minimum, maximum):\n" );
+    printf( "%.0f , %.0f , %.0f , %.0f\n",
+            resultMedian * pagesPerMegabyte, resultAverage * pagesPerMegabyte,
+            resultMinimum * pagesPerMegabyte, resultMaximum * pagesPerMegabyte );
+    }
+
+//--- Handler for output per-thread strings at test progress, if multi-thread ---
+// INPUT:   none, results of last walk used
+//---
+void printWalkThreads()
+    {
+    char threadName[PRINT_LIMIT];
+    int i = 0;
+    if ( threads < 2 ) return;
+    for ( i=0; i<threads; i++ )
+        {
+        snprintf( threadName, PRINT_LIMIT, "thread %d", i );
+        if ( walkContexts[i].cpu >= 0 )
+            {
+            printf( "       %-11s%8.3f   cpu %d\n", threadName, walkContexts[i].mbps, walkContexts[i].cpu );
+            }
+        else
+            {
+            printf( "       %-11s%8.3f   cpu n/a\n", threadName, walkContexts[i].mbps );
+            }
+        }
+    }
+
+//--- Helper method for detect target file system, page walk step and flags for page mode ---
+// INPUT:   filePath = target file path, directory of this file checked
+//          pageMode = selected page mode
+// OUTPUT:  update fsName, hugePageSize, walkStep, create, open and mapping flags
+//---
+void detectPageMode()
+    {
+    char dirPath[PATH_MAX];
+    struct statfs fsInfo;
+    FILE* sysFile = NULL;
+    unsigned long long pmdSize = 0;
+    int i = 0;
+    //--- Detect file system type by directory of target file ---
+    snprintf( dirPath, PATH_MAX, "%s", filePath );
+    fsMagic = 0;
+    fsName = fsNames[FS_OTHER];
+    if ( statfs( dirname( dirPath ), &fsInfo ) == 0 )
+        {
+        fsMagic = fsInfo.f_type;
+        for ( i=0; i<FS_OTHER; i++ )
+            {
+            if ( fsMagic == fsMagics[i] ) { fsName = fsNames[i]; }
+            }
+        }
+    //--- RAM-based file systems not support direct I/O, flags set again for each plan scenario ---
+    createFlags = O_RDWR|O_DIRECT|O_DSYNC|O_CREAT;
+    openFlags = O_RDWR|O_DIRECT|O_DSYNC;
+    mapFlags = MAP_SHARED;
+    if ( ( fsMagic == TMPFS_MAGIC ) | ( fsMagic == HUGETLBFS_MAGIC ) )
+        {
+        createFlags = O_RDWR|O_CREAT;
+        openFlags = O_RDWR;
+        }
+    //--- Page walk step is page size used by mapping, huge page step only for hugetlbfs ---
+    hugePageSize = 0;
+    if ( sysconf( _SC_PAGESIZE ) > 0 ) { pageSize = sysconf( _SC_PAGESIZE ); }
+    walkStep = pageSize;
+    if ( pageMode == PAGES_THP )
+        {
+        pmdSize = HUGE_PAGE_SIZE;
+        sysFile = fopen( THP_SIZE_PATH, "r" );
+        if ( sysFile != NULL )
+            {
+            if ( fscanf( sysFile, "%llu", &pmdSize ) != 1 ) { pmdSize = HUGE_PAGE_SIZE; }
+            fclose( sysFile );
+            }
+        hugePageSize = pmdSize;  // THP only requested, not guaranteed, base page walk step touches all pages
+        }
+    else if ( ( pageMode == PAGES_HUGETLB )&&( fsMagic == HUGETLBFS_MAGIC ) )
+        {
+        hugePageSize = fsInfo.f_bsize;
+        walkStep = hugePageSize;
+        mapFlags = MAP_SHARED|MAP_HUGETLB;
+        }
+    //--- Page walk step can be overridden by stride ---
+    if ( walkStride != 0 )
+        {
+        walkStep = walkStride;
+        }
+    }
+
+//--- Helper method for get huge page aligned address hint for mapping ---
+// Huge pages can be used only for aligned virtual addresses,
+// free address range reserved and released, aligned start of it used as hint.
+// INPUT:   length = mapping length, bytes
+//          alignment = required alignment, bytes, power of 2
+// OUTPUT:  aligned address hint, NULL if not available
+//---
+void* alignedMapHint( size_t length, size_t alignment )
+    {
+    size_t reserveLength = length + alignment;
+    char* reservePointer = mmap( NULL, reserveLength, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0 );
+    if ( reservePointer == MAP_FAILED )
+        {
+        return NULL;
+        }
+    munmap( reservePointer, reserveLength );
+    return (void*)( ( (size_t)reservePointer + alignment - 1 ) & ~( alignment - 1 ) );
+    }
+
+//--- Helper method for fill range of temporary file by pattern buffer ---
+// INPUT:   buffer = pattern buffer, BUFFER_SIZE bytes, aligned for direct I/O
+//          offset = range start in the file, bytes
+//          length = range length, bytes
+// OUTPUT:  status, 0=filled OK, otherwise error, messages output to console
+//---
+int fillRange( char* buffer, off_t offset, off_t length )
+    {
+    off_t addSize = 0;
+    ssize_t outSize = 0;
+    ssize_t count = BUFFER_SIZE;
+    while ( addSize < length )
+        {
+        if ( ( length - addSize ) < BUFFER_SIZE )
+            {
+            count = length - addSize;
+            }
+        outSize = pwrite( fileHandle, buffer, count, offset + addSize );
+        if ( outSize > 0 )
+            {
+            addSize += outSize;
+            }
+        else if ( outSize == 0 )
+            {
+            printf( "\nUnexpected zero size write error: %s", filePath );
+            return 3;
+            }
+        else
+            {
+            printf ( "\nFile write error: %s ( %s )\n", filePath, strerror(errno) );
+            return 3;
+            }
+        }
+    return 0;
+    }
+
+//--- File fill thread routine: fill own partition of file from own buffer ---
+// INPUT:   arg = pointer to FILL_CONTEXT of this thread
+// OUTPUT:  NULL, status stored to FILL_CONTEXT
+//---
+void* fillThread( void* arg )
+    {
+    FILL_CONTEXT* context = (FILL_CONTEXT*) arg;
+    char* buffer = memalign ( bufAlign, BUFFER_SIZE );
+    if ( buffer == NULL )
+        {
+        printf( "%s ( %s )\n", "Memory allocation failed", strerror(errno) );
+        context->status = 3;
+        return NULL;
+        }
+    memset ( buffer, setData, BUFFER_SIZE );
+    context->status = fillRange( buffer, context->offset, context->length );
+    free( buffer );
+    return NULL;
+    }
+
+//--- Helper method for create temporary file and fill it ---
+// hugetlbfs not supports write(), file size set and file filled by mapping,
+// mapped by chunks, because file can be above mapping limit.
+// Multi-thread fill by partitions of BUFFER_SIZE units for prepare=once, fallocate and sparse modes
+// allocate blocks or set size only, file not written.
+// INPUT:   filePath, fileSize, page mode and prepare mode variables
+// OUTPUT:  status, 0=created OK, otherwise error, messages output to console
+//---
+int createTestFile()
+    {
+    off_t units = ( fileSize + BUFFER_SIZE - 1 ) / BUFFER_SIZE;
+    off_t offset = 0;
+    off_t count = 0;
+    int fillThreads = ( prepareMode == PREPARE_ONCE ) ? threads : 1;  // each keeps single thread fill
+    int i = 0;
+    //--- Create file ---
+    fileHandle = open ( filePath, createFlags, S_IRUSR|S_IWUSR );    // open (create) file
+    if ( fileHandle <= 0 )
+        {
+        printf ( "\nFile create error: %s ( %s )\n", filePath, strerror(errno) );
+        return 3;
+        }
+    setData = '0';
+    if ( prepareMode == PREPARE_FALLOCATE )
+        {
+        //--- Allocate file blocks, not written ---
+        status = fallocate( fileHandle, 0, 0, fileSize );
+        if ( status < 0 )
+            {
+            printf ( "\nFile allocate error: %s ( %s )\n", filePath, strerror(errno) );
+            return 3;
+            }
+        }
+    else if ( prepareMode == PREPARE_SPARSE )
+        {
+        //--- Set file size, no blocks allocated ---
+        status = ftruncate( fileHandle, fileSize );
+        if ( status < 0 )
+            {
+            printf ( "\nFile size set error: %s ( %s )\n", filePath, strerror(errno) );
+            return 3;
+            }
+        }
+    else if ( pageMode == PAGES_HUGETLB )
+        {
+        //--- Set file size and fill file by mapping ---
+        status = ftruncate( fileHandle, fileSize );
+        if ( status < 0 )
+            {
+            printf ( "\nFile size set error: %s ( %s )\n", filePath, strerror(errno) );
+            return 3;
+            }
+        off_t fillOffset = 0;
+        size_t fillSize = hugePageSize;
+        while ( fillSize < FILL_CHUNK ) { fillSize *= 2; }
+        for ( fillOffset=0; fillOffset<fileSize; fillOffset+=fillSize )
+            {
+            if ( ( fileSize - fillOffset ) < fillSize ) { fillSize = fileSize - fillOffset; }
+            diskData = mmap( NULL, fillSize, mapProtect, mapFlags, fileHandle, fillOffset );
+            if ( diskData == MAP_FAILED )
+                {
+                printf ( "\nFile mapping error: %s ( %s )\n", filePath, strerror(errno) );
+                return 3;
+                }
+            memset ( diskData, setData, fillSize );
+            munmap ( diskData, fillSize );
+            }
+        }
+    else
+        {
+        //--- Write file from buffers, partition per thread ---
+        if ( fillThreads > units ) { fillThreads = units; }
+        for ( i=0; i<fillThreads; i++ )
+            {
+            count = units / fillThreads;
+            if ( i < ( units % fillThreads ) ) { count++; }
+            count *= BUFFER_SIZE;
+            if ( count > ( fileSize - offset ) ) { count = fileSize - offset; }
+            fillContexts[i].offset = offset;
+            fillContexts[i].length = count;
+            fillContexts[i].status = 0;
+            offset += count;
+            status = pthread_create( &fillContexts[i].thread, NULL, fillThread, &fillContexts[i] );
+            if ( status != 0 )
+                {
+                printf( "\nThread create error ( %s )\n", strerror(status) );
+                return 3;
+                }
+            }
+        for ( i=0; i<fillThreads; i++ )
+            {
+            status = pthread_join( fillContexts[i].thread, NULL );
+            if ( status != 0 )
+                {
+                printf( "\nThread join error ( %s )\n", strerror(status) );
+                return 3;
+                }
+            if ( fillContexts[i].status != 0 ) return fillContexts[i].status;
+            }
+        }
+    //--- Close file ---
+    status = close( fileHandle );
+    if ( status < 0 )
+        {
+        printf ( "\nFile close error: %s ( %s )\n", filePath, strerror(errno) );
+        return 3;
+        }
+    return 0;
+    }
+
+//--- Helper method for open temporary file ---
+// INPUT:   filePath
+// OUTPUT:  status, 0=opened OK, otherwise error, messages output to console
+//          update fileHandle
+//---
+int openTestFile()
+    {
+    fileHandle = open ( filePath, openFlags );    // open file
+    if ( fileHandle <= 0 )
+        {
+        printf ( "\nFile open error: %s ( %s )\n", filePath, strerror(errno) );
+        return 3;
+        }
+    return 0;
+    }
+
+//--- Helper method for flush temporary file and evict it from page cache ---
+// Reused file state made same as newly created by direct I/O: written back, not cached.
+// INPUT:   fileHandle
+// OUTPUT:  status, 0=evicted OK, otherwise error, messages output to console
+//---
+int evictTestFile()
+    {
+    status = fdatasync( fileHandle );
+    if ( status < 0 )
+        {
+        printf ( "\nFile flush error: %s ( %s )\n", filePath, strerror(errno) );
+        return 3;
+        }
+    status = posix_fadvise( fileHandle, 0, 0, POSIX_FADV_DONTNEED );
+    if ( status != 0 )
+        {
+        printf ( "\nFile advice error: %s ( %s )\n", filePath, strerror(status) );
+        return 3;
+        }
+    return 0;
+    }
+
+//--- Helper method for drop clean page cache, privileged runs only ---
+// INPUT:   none
+// OUTPUT:  status, 0=dropped OK, otherwise error, messages output to console
+//---
+int dropCaches()
+    {
+    FILE* dropFile = NULL;
+    sync();
+    dropFile = fopen( DROP_CACHES_PATH, "w" );
+    if ( dropFile == NULL )
+        {
+        printf ( "\nDrop caches error: %s ( %s )\n", DROP_CACHES_PATH, strerror(errno) );
+        return 3;
+        }
+    status = fputs( "1", dropFile );
+    if ( ( fclose( dropFile ) != 0 )|( status < 0 ) )
+        {
+        printf ( "\nDrop caches error: %s ( %s )\n", DROP_CACHES_PATH, strerror(errno) );
+        return 3;
+        }
+    return 0;
+    }
+
+//--- Helper method for pre-read temporary file to page cache by read() ---
+// File opened again without O_DIRECT, because direct reads bypass page cache.
+// INPUT:   filePath, fileSize
+// OUTPUT:  status, 0=read OK, otherwise error, messages output to console
+//---
+int preReadTestFile()
+    {
+    int readHandle = 0;
+    ssize_t inSize = 0;
+    char* buffer = memalign( bufAlign, BUFFER_SIZE );
+    if ( buffer == NULL )
+        {
+        printf( "%s ( %s )\n", "Memory allocation failed", strerror(errno) );
+        return 3;
+        }
+    readHandle = open( filePath, O_RDONLY );
+    if ( readHandle <= 0 )
+        {
+        printf ( "\nFile open error: %s ( %s )\n", filePath, strerror(errno) );
+        free( buffer );
+        return 3;
+        }
+    do  {
+        inSize = read( readHandle, buffer, BUFFER_SIZE );
+        } while ( inSize > 0 );
+    if ( inSize < 0 )
+        {
+        printf ( "\nFile read error: %s ( %s )\n", filePath, strerror(errno) );
+        }
+    close( readHandle );
+    free( buffer );
+    return ( inSize < 0 ) ? 3 : 0;
+    }
+
+//--- Helper method for set page cache state of temporary file before walk ---
+// Write pass: reused file evicted, same as newly created by direct I/O.
+// Read pass: file evicted, then dropped, pre-read or nothing by cache mode,
+// hot mode mapping pre-touch done after mapping by preTouchMapping().
+// INPUT:   operation = WALK_WRITE or WALK_READ
+// OUTPUT:  status, 0=state set OK, otherwise error, messages output to console
+//---
+int setCacheState( int operation )
+    {
+    if ( ( operation == WALK_WRITE )&&( prepareMode == PREPARE_EACH ) ) return 0;
+    status = evictTestFile();
+    if ( ( status != 0 )||( operation == WALK_WRITE ) ) return status;
+    if ( cacheMode == CACHE_DROP )
+        {
+        status = dropCaches();
+        }
+    else if ( cacheMode >= CACHE_WARM )
+        {
+        status = preReadTestFile();
+        }
+    return status;
+    }
+
+//--- Helper method for pre-touch current mapping, hot page cache state ---
+// INPUT:   mapPointer, mapLength
+// OUTPUT:  none, mapped pages faulted in
+//---
+void preTouchMapping()
+    {
+    volatile char* touchPointer = mapPointer;    // volatile prevents reads elimination
+    size_t offset = 0;
+    for ( offset=0; offset<mapLength; offset+=pageSize )
+        {
+        (void)touchPointer[offset];
+        }
+    }
+
+//--- Helper method for get part of temporary file resident in page cache ---
+// File mapped by chunks without access, mincore() not faults pages in.
+// INPUT:   fileHandle, fileSize
+// OUTPUT:  resident part of file, percents, -1 if not available
+//---
+double getResidentPercent()
+    {
+    unsigned char* vector = NULL;
+    void* chunkPointer = NULL;
+    size_t chunkSize = FILL_CHUNK;
+    size_t chunkPages = 0;
+    size_t i = 0;
+    off_t offset = 0;
+    off_t resident = 0;
+    if ( chunkSize < hugePageSize ) { chunkSize = hugePageSize; }
+    vector = malloc( chunkSize / pageSize );
+    if ( vector == NULL ) return -1.0;
+    for ( offset=0; offset<fileSize; offset+=chunkSize )
+        {
+        if ( ( fileSize - offset ) < chunkSize ) { chunkSize = fileSize - offset; }
+        chunkPages = ( chunkSize + pageSize - 1 ) / pageSize;
+        chunkPointer = mmap( NULL, chunkSize, PROT_READ, mapFlags, fileHandle, offset );
+        if ( chunkPointer == MAP_FAILED )
+            {
+            free( vector );
+            return -1.0;
+            }
+        if ( mincore( chunkPointer, chunkSize, vector ) < 0 )
+            {
+            munmap( chunkPointer, chunkSize );
+            free( vector );
+            return -1.0;
+            }
+        for ( i=0; i<chunkPages; i++ )
+            {
+            if ( vector[i] & 1 ) { resident += pageSize; }
+            }
+        munmap( chunkPointer, chunkSize );
+        }
+    free( vector );
+    if ( resident > fileSize ) { resident = fileSize; }
+    return resident * 100.0 / fileSize;
+    }
+
+//--- Handler for output page cache state string at test progress ---
+// INPUT:   none, residentPercent of last walk used
+//---
+void printCacheState()
+    {
+    if ( residentPercent < 0.0 )
+        {
+        printf( "       cached     n/a\n" );
+        return;
+        }
+    printf( "       cached     %.1f%% of file resident before walk\n", residentPercent );
+    }
+
+//--- Helper method for map window of temporary file to virtual address space ---
+// INPUT:   offset = window start in the file, bytes, page aligned
+//          length = window length, bytes
+//          fileHandle, page mode, advice and prefault variables
+// OUTPUT:  status, 0=mapped OK, otherwise error, messages output to console
+//          update mapPointer, mapLength, mapOffset, populateSeconds
+//---
+int mapWindow( off_t offset, size_t length )
+    {
+    struct timespec tsPopulate1, tsPopulate2;
+    //--- Map file window to virtual address space, huge pages require aligned address ---
+    mapLength = length;
+    mapOffset = offset;
+    mapInput = NULL;
+    if ( hugePageSize > 0 )
+        {
+        mapInput = alignedMapHint( mapLength, hugePageSize );
+        }
+    //--- MAP_POPULATE prefault done by mmap(), time of mmap() is prefault time ---
+    int flags = mapFlags;
+    if ( populateMode == POPULATE_MAP ) { flags |= MAP_POPULATE; }
+    readTime( &tsPopulate1 );
+    mapPointer = mmap( mapInput, mapLength, mapProtect, flags,  // map file 
+                    fileHandle, mapOffset );
+    readTime( &tsPopulate2 );
+    if ( mapPointer == MAP_FAILED )
+        {
+        printf ( "\nFile mapping error: %s ( %s )\n", filePath, strerror(errno) );
+        return 3;
+        }
+    populateSeconds = 0.0;
+    if ( populateMode == POPULATE_MAP ) { populateSeconds = secondsDelta( &tsPopulate1, &tsPopulate2 ); }
+    //--- Transparent huge pages request for mapping ---
+    if ( pageMode == PAGES_THP )
+        {
+        status = madvise( mapPointer, mapLength, MADV_HUGEPAGE );
+        if ( status < 0 )
+            {
+            printf ( "\nHuge pages advice error: %s ( %s )\n", filePath, strerror(errno) );
+            return 3;
+            }
+        }
+    //--- Access pattern advice for mapping or for file, before timed walk ---
+    if ( ( adviceMode >= ADVICE_MADV )&&( adviceMode < ADVICE_FADV ) )
+        {
+        status = madvise( mapPointer, mapLength, adviceValues[adviceMode] );
+        if ( status < 0 )
+            {
+            printf ( "\nMapping advice error: %s ( %s )\n", filePath, strerror(errno) );
+            return 3;
+            }
+        }
+    else if ( ( adviceMode >= ADVICE_FADV )&&( adviceMode < ADVICE_ALL ) )
+        {
+        status = posix_fadvise( fileHandle, mapOffset, mapLength, adviceValues[adviceMode] );
+        if ( status != 0 )
+            {
+            printf ( "\nFile advice error: %s ( %s )\n", filePath, strerror(status) );
+            return 3;
+            }
+        }
+    //--- Prefault mapping, this step timed separately from walk ---
+    if ( populateMode > POPULATE_MAP )
+        {
+        readTime( &tsPopulate1 );
+        if ( populateMode == POPULATE_MLOCK )
+            {
+            status = mlock( mapPointer, mapLength );
+            }
+        else
+            {
+            status = madvise( mapPointer, mapLength, populateValues[populateMode] );
+            }
+        readTime( &tsPopulate2 );
+        if ( status < 0 )
+            {
+            printf ( "\nMapping prefault error: %s ( %s )\n", filePath, strerror(errno) );
+            return 3;
+            }
+        populateSeconds = secondsDelta( &tsPopulate1, &tsPopulate2 );
+        }
+    return 0;
+    }
+
+//--- Handler for output prefault string at test progress, if prefault used ---
+// INPUT:   statArray[] = prefault statistic array, stepNumber entries used
+//          stepNumber = number of step (pass)
+//---
+void printPopulate( double statArray[], int stepNumber )
+    {
+    if ( populateMode == POPULATE_NONE ) return;
+    printf( "       %-11s%8.3f   %.3f ms\n", "prefault", statArray[stepNumber], populateSeconds * 1000.0 );
+    }
+
+//--- Handler for output mixed walk strings at test progress ---
+// Write and read speeds by time of own accesses, sum of threads, latencies of each access.
+// INPUT:   none, mixOps[], mixMbps[], mixLatency[] of last mixed walk used
+//---
+void printMixed()
+    {
+    printf( "       %-11s%8.3f   %llu accesses\n", "write", mixMbps[WALK_WRITE], mixOps[WALK_WRITE] );
+    printLatency( "write lat", &mixLatency[WALK_WRITE] );
+    printf( "       %-11s%8.3f   %llu accesses\n", "read", mixMbps[WALK_READ], mixOps[WALK_READ] );
+    printLatency( "read lat", &mixLatency[WALK_READ] );
+    }
+
+//--- Handler for output flush strings at test progress, if write flush used ---
+// Pass time split to dirtying walk, include windows mapping if used, and flush.
+// INPUT:   stepNumber = number of step (pass)
+//          seconds = total time of last write pass, flushSeconds, dirtyLog[], flushLog[]
+//---
+void printFlush( int stepNumber )
+    {
+    double dirtySeconds = seconds - flushSeconds;
+    if ( wsyncMode == WSYNC_NONE ) return;
+    printf( "       %-11s%8.3f   %.3f ms\n", "dirty", dirtyLog[stepNumber], dirtySeconds * 1000.0 );
+    printf( "       %-11s%8.3f   %.3f ms, %s\n", "flush", flushLog[stepNumber], flushSeconds * 1000.0,
+            wsyncModes[wsyncMode] );
+    }
+
+//--- Handler for output current string at soak progress, streaming statistics ---
+// Same columns as handlerProgress(), median by P-square estimator, drift reported if detected.
+// INPUT:   operation = WALK_WRITE or WALK_READ
+//          rep = pass number, 0-based
+//          mbps = result of pass
+// OUTPUT:  update soakTotal[], soakInterval[], soakDrift[]
+//---
+void soakProgress( int operation, int rep )
+    {
+    struct timespec tsNow;
+    int i = ( operation == WALK_WRITE ) ? 0 : 1;
+    char* passName = ( operation == WALK_WRITE ) ? "write" : "read";
+    double oldLevel = 0.0, newLevel = 0.0;
+    long long changeSamples = 0;
+    streamAdd( &soakTotal[i], mbps );
+    streamAdd( &soakInterval[i], mbps );
+    printf( " %-6d%-11s%8.3f%11.3f%11.3f%11.3f%11.3f\n",
+            rep + 1, passName, mbps, p2Value( &soakTotal[i].p50 ),
+            soakTotal[i].mean, soakTotal[i].minimum, soakTotal[i].maximum );
+    if ( driftAdd( &soakDrift[i], mbps, &oldLevel, &newLevel, &changeSamples ) == 0 ) return;
+    readTime( &tsNow );
+    printf( "\n DRIFT %s: pass %d, %.1f s, %.3f MBPS -> %.3f MBPS ( %+.1f%% ), change %lld passes ago\n\n",
+            passName, rep + 1, secondsDelta( &tsSoak, &tsNow ), oldLevel, newLevel,
+            ( newLevel - oldLevel ) * 100.0 / oldLevel, changeSamples );
+    outputDouble( "drift", passName, rep + 1, "elapsed_seconds", secondsDelta( &tsSoak, &tsNow ) );
+    outputDouble( "drift", passName, rep + 1, "baseline_mbps", oldLevel );
+    outputDouble( "drift", passName, rep + 1, "level_mbps", newLevel );
+    outputDouble( "drift", passName, rep + 1, "change_percent", ( newLevel - oldLevel ) * 100.0 / oldLevel );
+    outputInteger( "drift", passName, rep + 1, "change_passes", changeSamples );
+    }
+
+//--- Handler for output soak summary, periodic or totals ---
+// INPUT:   final = 0 for summary of interval, interval statistics cleared after it,
+//          1 for totals of all passes
+//          soakTotal[], soakInterval[], soakDrift[]
+//---
+void soakSummary( int final )
+    {
+    struct timespec tsNow;
+    char* names[] = { "write", "read" };
+    char* section = final ? "statistics" : "soak";
+    int pass = final ? 0 : soakSummaries + 1;
+    STREAM_STAT* stat = NULL;
+    char intervalName[PRINT_LIMIT];
+    int i = 0;
+    readTime( &tsNow );
+    if ( final )
+        {
+        printf( "\nSoak totals, %.1f s (MBPS, median and percentiles by P-square):\n", secondsDelta( &tsSoak, &tsNow ) );
+        }
+    else
+        {
+        printf( "\nSoak summary %d, %.1f s (MBPS, interval mean, then all passes):\n", pass, secondsDelta( &tsSoak, &tsNow ) );
+        }
+    printf( "Operation | Passes   | Interval   | Mean       | Stddev   | P5         | Median     | P95        | Drifts\n" );
+    printf( "---------------------------------------------------------------------------------------------------------\n" );
+    for ( i=0; i<2; i++ )
+        {
+        stat = &soakTotal[i];
+        snprintf( intervalName, PRINT_LIMIT, "%.3f", soakInterval[i].mean );
+        printf( " %-10s%-11lld%-13s%-13.3f%-11.3f%-13.3f%-13.3f%-13.3f%d\n",
+                names[i], stat->count, final ? "-" : intervalName, stat->mean, streamStddev( stat ),
+                p2Value( &stat->p5 ), p2Value( &stat->p50 ), p2Value( &stat->p95 ), soakDrift[i].drifts );
+        outputInteger( section, names[i], pass, "passes", stat->count );
+        if ( !final ) { outputDouble( section, names[i], pass, "interval_mean", soakInterval[i].mean ); }
+        outputDouble( section, names[i], pass, "mean", stat->mean );
+        outputDouble( section, names[i], pass, "stddev", streamStddev( stat ) );
+        outputDouble( section, names[i], pass, "minimum", stat->minimum );
+        outputDouble( section, names[i], pass, "maximum", stat->maximum );
+        outputDouble( section, names[i], pass, "p5", p2Value( &stat->p5 ) );
+        outputDouble( section, names[i], pass, "median", p2Value( &stat->p50 ) );
+        outputDouble( section, names[i], pass, "p95", p2Value( &stat->p95 ) );
+        outputInteger( section, names[i], pass, "drifts", soakDrift[i].drifts );
+        if ( !final ) { streamClear( &soakInterval[i] ); }
+        }
+    printf( "\n" );
+    if ( !final ) { soakSummaries++; }
+    }
+
+//--- Helper method for unmap window of temporary file ---
+// INPUT:   mapPointer, mapLength
+// OUTPUT:  status, 0=unmapped OK, otherwise error, messages output to console
+//          mapPointer cleared
+//---
+int unmapWindow()
+    {
+    status = munmap( mapPointer, mapLength );
+    if ( status < 0 )
+        {
+        printf ( "\nFile un-mapping error: %s ( %s )\n", filePath, strerror(errno) );
+        return 3;
+        }
+    mapPointer = NULL;
+    return 0;
+    }
+
+//--- Helper method for close temporary file ---
+// INPUT:   filePath, fileHandle
+// OUTPUT:  status, 0=closed OK, otherwise error, messages output to console
+//---
+int closeTestFile()
+    {
+    status = close( fileHandle );
+    if ( status < 0 )
+        {
+        printf ( "\nFile close error: %s ( %s )\n", filePath, strerror(errno) );
+        return 3;
+        }
+    return 0;
+    }
+
+//--- Helper method for delete temporary file ---
+// INPUT:   filePath
+// OUTPUT:  status, 0=deleted OK, otherwise error, messages output to console
+//---
+int removeTestFile()
+    {
+    status = remove( filePath );
+    if ( status < 0 )
+        {
+        printf ( "\nFile delete error: %s ( %s )\n", filePath, strerror(errno) );
+        return 3;
+        }
+    return 0;
+    }
+
+//--- Helper method for get size of mapping really backed by huge pages, from /proc/self/smaps ---
+// INPUT:   address = mapping start address
+// OUTPUT:  size backed by huge pages (THP or hugetlbfs), bytes, -1 if not available
+//---
+long long hugeMappedSize( void* address )
+    {
+    char line[SMAPS_LINE];
+    unsigned long long vmaStart = 0, vmaStop = 0;
+    unsigned long long kb = 0;
+    long long total = -1;
+    int found = 0;
+    int i = 0;
+    FILE* smapsFile = fopen( SMAPS_PATH, "r" );
+    if ( smapsFile == NULL )
+        {
+        return -1;
+        }
+    while ( fgets( line, SMAPS_LINE, smapsFile ) != NULL )
+        {
+        if ( sscanf( line, "%llx-%llx", &vmaStart, &vmaStop ) == 2 )
+            {  // VMA header line, fields of required VMA follows it
+            if ( found ) break;
+            found = ( vmaStart == (unsigned long long)(size_t)address );
+            if ( found ) total = 0;
+            }
+        else if ( found )
+            {
+            for ( i=0; smapsHugeFields[i]!=NULL; i++ )
+                {
+                if ( ( strncmp( line, smapsHugeFields[i], strlen( smapsHugeFields[i] ) ) == 0 )&&
+                     ( sscanf( line + strlen( smapsHugeFields[i] ), "%llu", &kb ) == 1 ) )
+                    {
+                    total += kb * 1024;
+                    }
+                }
+            }
+        }
+    fclose( smapsFile );
+    return total;
+    }
+
+//--- Handler for output huge pages usage string at test progress, if huge pages mode ---
+// INPUT:   none, current mapping used
+//---
+void printHugePages()
+    {
+    long long hugeSize = 0;
+    if ( hugePageSize == 0 ) return;
+    hugeSize = -1;
+    if ( mapPointer != NULL ) { hugeSize = hugeMappedSize( mapPointer ); }
+    if ( hugeSize < 0 )
+        {
+        printf( "       huge pages n/a\n" );
+        return;
+        }
+    printf( "       huge pages %lld of %llu (", 
+            hugeSize / hugePageSize, 
+            (unsigned long long)( ( mapLength + hugePageSize - 1 ) / hugePageSize ) );
+    printMemorySize( hugePageSize );
+    printf( ")\n" );
+    }
+
+//--- Helper method for get memory parameter from /proc/meminfo or /proc/self/status ---
+// INPUT:   path = file path, MEMINFO_PATH or STATUS_PATH
+//          name = parameter name with colon, example "MemTotal:"
+// OUTPUT:  parameter value, bytes, -1 if not available
+//---
+long long readProcValue( char* path, char* name )
+    {
+    char line[SMAPS_LINE];
+    unsigned long long kb = 0;
+    long long value = -1;
+    FILE* procFile = fopen( path, "r" );
+    if ( procFile == NULL )
+        {
+        return -1;
+        }
+    while ( fgets( line, SMAPS_LINE, procFile ) != NULL )
+        {
+        if ( ( strncmp( line, name, strlen( name ) ) == 0 )&&
+             ( sscanf( line + strlen( name ), "%llu", &kb ) == 1 ) )
+            {
+            value = kb * 1024;
+            break;
+            }
+        }
+    fclose( procFile );
+    return value;
+    }
+
+//--- Helper method for read named fields of /proc file, "name value" or "name: value" lines ---
+// INPUT:   path = /proc file path
+//          first = index of first field in kstatNames[]
+//          count = number of fields
+//          values = array of KSTAT_FIELDS values, fields updated, KSTAT_NA if not found
+// OUTPUT:  none
+//---
+void readProcFields( char* path, int first, int count, long long* values )
+    {
+    char line[SMAPS_LINE];
+    long long value = 0;
+    int i = 0, length = 0;
+    FILE* procFile = NULL;
+    for ( i=first; i<(first+count); i++ ) { values[i] = KSTAT_NA; }
+    procFile = fopen( path, "r" );
+    if ( procFile == NULL ) return;
+    while ( fgets( line, SMAPS_LINE, procFile ) != NULL )
+        {
+        for ( i=first; i<(first+count); i++ )
+            {
+            length = strlen( kstatNames[i] );
+            if ( ( strncmp( line, kstatNames[i], length ) == 0 )&&
+                 ( ( line[length] == ' ' )||( line[length] == ':' ) )&&
+                 ( sscanf( line + length + 1, "%lld", &value ) == 1 ) )
+                {
+                values[i] = value;
+                break;
+                }
+            }
+        }
+    fclose( procFile );
+    }
+
+//--- Helper method for read total stall times of pressure stall information file ---
+// INPUT:   path = /proc/pressure file path
+//          values = pointer to two values: "some" and "full" total, microseconds, KSTAT_NA if n/a
+// OUTPUT:  none
+//---
+void readPressure( char* path, long long* values )
+    {
+    char line[SMAPS_LINE];
+    char* total = NULL;
+    FILE* procFile = fopen( path, "r" );
+    values[0] = KSTAT_NA;
+    values[1] = KSTAT_NA;
+    if ( procFile == NULL ) return;
+    while ( fgets( line, SMAPS_LINE, procFile ) != NULL )
+        {
+        total = strstr( line, "total=" );
+        if ( total == NULL ) continue;
+        if ( strncmp( line, "some", 4 ) == 0 ) { values[0] = atoll( total + 6 ); }
+        if ( strncmp( line, "full", 4 ) == 0 ) { values[1] = atoll( total + 6 ); }
+        }
+    fclose( procFile );
+    }
+
+//--- Helper method for snapshot all kernel counters ---
+// INPUT:   values = array of KSTAT_FIELDS values, updated, KSTAT_NA if n/a
+// OUTPUT:  none
+//---
+void readKernelCounters( long long* values )
+    {
+    readProcFields( VMSTAT_PATH, KSTAT_VMSTAT, KSTAT_IO - KSTAT_VMSTAT, values );
+    readProcFields( IO_PATH, KSTAT_IO, KSTAT_PSI - KSTAT_IO, values );
+    readPressure( PSI_IO_PATH, values + KSTAT_PSI );
+    readPressure( PSI_MEMORY_PATH, values + KSTAT_PSI + 2 );
+    }
+
+//--- Helper method for start kernel counters phase ---
+// INPUT:   phase = PHASE_WRITE, PHASE_FLUSH or PHASE_READ
+// OUTPUT:  none, phase deltas blanked, kstatStart[] updated
+//---
+void kstatBegin( int phase )
+    {
+    int i = 0;
+    for ( i=0; i<KSTAT_FIELDS; i++ ) { kstatDelta[phase][i] = KSTAT_NA; }
+    if ( kstatMode == 0 ) return;
+    readKernelCounters( kstatStart );
+    }
+
+//--- Helper method for stop kernel counters phase ---
+// INPUT:   phase = PHASE_WRITE, PHASE_FLUSH or PHASE_READ
+// OUTPUT:  none, kstatDelta[phase][] updated, KSTAT_NA if field n/a
+//---
+void kstatEnd( int phase )
+    {
+    long long values[KSTAT_FIELDS];
+    int i = 0;
+    if ( kstatMode == 0 ) return;
+    readKernelCounters( values );
+    for ( i=0; i<KSTAT_FIELDS; i++ )
+        {
+        if ( ( values[i] != KSTAT_NA )&&( kstatStart[i] != KSTAT_NA ) ) { kstatDelta[phase][i] = values[i] - kstatStart[i]; }
+        }
+    }
+
+//--- Helper method for print kernel counters phase deltas ---
+// nr_dirty and nr_writeback are current values, delta printed with sign.
+// INPUT:   name = row name
+//          phase = PHASE_WRITE, PHASE_FLUSH or PHASE_READ
+// OUTPUT:  none, messages output to console
+//---
+void printKernelCounters( char* name, int phase )
+    {
+    int i = 0;
+    if ( kstatMode == 0 ) return;
+    printf( "       %-11s", name );
+    for ( i=0; i<KSTAT_FIELDS; i++ )
+        {
+        if ( i > 0 ) { printf( ", " ); }
+        if ( kstatDelta[phase][i] == KSTAT_NA ) { printf( "%s n/a", kstatNames[i] ); }
+        else if ( ( i == KSTAT_GAUGES )||( i == ( KSTAT_GAUGES + 1 ) ) ) { printf( "%s %+lld", kstatNames[i], kstatDelta[phase][i] ); }
+        else { printf( "%s %lld", kstatNames[i], kstatDelta[phase][i] ); }
+        }
+    printf( "\n" );
+    }
+
+//--- Helper method for detect block device backing target file, by st_dev of its directory ---
+// Partition has own stat file, device mapper and md devices resolved as is,
+// file systems without block device (tmpfs, overlay, nfs) have anonymous st_dev, not resolved.
+// INPUT:   filePath
+// OUTPUT:  status, 0=device resolved, 1=not resolved, update devStatPath, devName
+//---
+int detectDevice()
+    {
+    char dirPath[PATH_MAX];
+    char linkPath[64];
+    char target[PATH_MAX];
+    struct stat dirInfo;
+    ssize_t length = 0;
+    devStatPath[0] = 0;
+    snprintf( devNameBuffer, PATH_MAX, "n/a" );
+    snprintf( dirPath, PATH_MAX, "%s", filePath );
+    if ( stat( dirname( dirPath ), &dirInfo ) != 0 ) return 1;
+    snprintf( linkPath, sizeof( linkPath ), "%s/%u:%u", SYS_BLOCK_PATH, major( dirInfo.st_dev ), minor( dirInfo.st_dev ) );
+    snprintf( devNameBuffer, PATH_MAX, "n/a, no block device for %u:%u", major( dirInfo.st_dev ), minor( dirInfo.st_dev ) );
+    length = readlink( linkPath, target, PATH_MAX - 1 );
+    if ( length <= 0 ) return 1;
+    target[length] = 0;
+    snprintf( devStatPath, PATH_MAX, "%s/stat", linkPath );
+    if ( access( devStatPath, R_OK ) != 0 ) { devStatPath[0] = 0; return 1; }
+    snprintf( devNameBuffer, PATH_MAX, "%s (%u:%u)", basename( target ), major( dirInfo.st_dev ), minor( dirInfo.st_dev ) );
+    return 0;
+    }
+
+//--- Helper method for read block device stat file ---
+// INPUT:   values = array of DEVSTAT_FIELDS values, updated
+// OUTPUT:  status, 0=read OK, 1=not available
+//---
+int readDeviceStat( unsigned long long* values )
+    {
+    FILE* statFile = NULL;
+    int i = 0, count = 0;
+    if ( devStatPath[0] == 0 ) return 1;
+    statFile = fopen( devStatPath, "r" );
+    if ( statFile == NULL ) return 1;
+    for ( i=0; i<DEVSTAT_FIELDS; i++ ) { count += fscanf( statFile, "%llu", &values[i] ); }
+    fclose( statFile );
+    return count == DEVSTAT_FIELDS ? 0 : 1;
+    }
+
+//--- Helper method for start block device statistics phase ---
+// INPUT:   phase = PHASE_WRITE, PHASE_FLUSH or PHASE_READ
+// OUTPUT:  none, phase deltas blanked, devStart[] updated
+//---
+void devstatBegin( int phase )
+    {
+    int i = 0;
+    for ( i=0; i<DEVSTAT_FIELDS; i++ ) { devDelta[phase][i] = -1; }
+    if ( devstatMode == 0 ) return;
+    if ( readDeviceStat( devStart ) != 0 ) { devStart[0] = ~0ULL; }
+    }
+
+//--- Helper method for stop block device statistics phase ---
+// INPUT:   phase = PHASE_WRITE, PHASE_FLUSH or PHASE_READ
+// OUTPUT:  none, devDelta[phase][] updated, -1 if n/a
+//---
+void devstatEnd( int phase )
+    {
+    unsigned long long values[DEVSTAT_FIELDS];
+    int i = 0;
+    if ( ( devstatMode == 0 )||( devStart[0] == ~0ULL ) ) return;
+    if ( readDeviceStat( values ) != 0 ) return;
+    for ( i=0; i<DEVSTAT_FIELDS; i++ ) { devDelta[phase][i] = values[i] - devStart[i]; }
+    }
+
+//--- Helper method for print block device statistics phase deltas ---
+// Device counts all IO of device, not only this benchmark.
+// INPUT:   name = row name
+//          phase = PHASE_WRITE, PHASE_FLUSH or PHASE_READ
+// OUTPUT:  none, messages output to console
+//---
+void printDeviceStat( char* name, int phase )
+    {
+    long long* values = devDelta[phase];
+    double readBytes = 0.0, writeBytes = 0.0;
+    long long ios = 0;
+    if ( devstatMode == 0 ) return;
+    printf( "       %-11s", name );
+    if ( values[DEV_READ_IOS] < 0 )
+        {
+        printf( "n/a\n" );
+        return;
+        }
+    readBytes = (double)values[DEV_READ_SECTORS] * SECTOR_BYTES;
+    writeBytes = (double)values[DEV_WRITE_SECTORS] * SECTOR_BYTES;
+    ios = values[DEV_READ_IOS] + values[DEV_WRITE_IOS];
+    printf( "read %lld IOs %.0f KB avg %.1f KB, write %lld IOs %.0f KB avg %.1f KB, ",
+            values[DEV_READ_IOS], readBytes / 1024.0,
+            values[DEV_READ_IOS] > 0 ? readBytes / 1024.0 / values[DEV_READ_IOS] : 0.0,
+            values[DEV_WRITE_IOS], writeBytes / 1024.0,
+            values[DEV_WRITE_IOS] > 0 ? writeBytes / 1024.0 / values[DEV_WRITE_IOS] : 0.0 );
+    printf( "queue %lld ms, wait %.3f ms/IO, write amplification %.3f\n",
+            values[DEV_QUEUE_TICKS],
+            ios > 0 ? (double)( values[DEV_READ_TICKS] + values[DEV_WRITE_TICKS] ) / ios : 0.0,
+            writeBytes / fileSize );
+    }
+
+//--- Helper method for flush written range to storage by selected primitive ---
+// fsync() and fdatasync() flush whole file, msync() requires range in current mapping.
+// INPUT:   offset = flushed range start in the file, bytes, page aligned
+//          length = flushed range length, bytes, 0 means up to end of file
+// OUTPUT:  status, 0=flushed OK, otherwise error, messages output to console
+//---
+int flushRange( off_t offset, size_t length )
+    {
+    switch ( wsyncMode )
+        {
+        case WSYNC_FSYNC:
+            status = fsync( fileHandle );
+            break;
+        case WSYNC_FDATASYNC:
+            status = fdatasync( fileHandle );
+            break;
+        case WSYNC_MSYNC:
+        case WSYNC_MSYNC_ASYNC:
+            if ( length == 0 ) { length = mapLength - ( offset - mapOffset ); }
+            status = msync( (char*)mapPointer + ( offset - mapOffset ), length, wsyncValues[wsyncMode] );
+            break;
+        case WSYNC_SFR:
+        case WSYNC_SFR_WAIT:
+        case WSYNC_SFR_WAITALL:
+            status = sync_file_range( fileHandle, offset, length, wsyncValues[wsyncMode] );
+            break;
+        default:
+            status = 0;
+            break;
+        }
+    if ( status < 0 )
+        {
+        printf ( "\nFile flush error: %s ( %s )\n", filePath, strerror(errno) );
+        return 3;
+        }
+    return 0;
+    }
+
+//--- Run page walk by windows: map, walk and unmap fixed-size windows in turn ---
+// Mapping and unmapping of windows are inside timed interval, each of
+// mmap(), walk and munmap() also timed separately. Window moves by window
+// size minus overlap, last window can be shorter if not fits file size.
+// Walk threads created once before timed interval, each window handed to them.
+// Resident size sampled for first window only, before it unmapped.
+// INPUT:   operation = WALK_WRITE or WALK_READ
+//          data = data pattern for write
+// OUTPUT:  status, 0=walk OK, otherwise error, messages output to console
+//          ts1 = time measurement start point, before first window mapped
+//          update per-thread results and populateSeconds, summary for all windows,
+//          update windowCount, windowBytes, windowMapSeconds, windowWalkSeconds, windowUnmapSeconds,
+//          windowResident, flushSeconds if write flushed by msync() per window,
+//          excludedSeconds = walk threads exit and join time
+//---
+int windowWalk( int operation, char data )
+    {
+    struct timespec tsWindows, tsMap, tsMapped, tsWalk, tsUnmap;
+    double threadSeconds[THREADS_MAX];
+    double threadMegabytes[THREADS_MAX];
+    double windowsPopulate = 0.0;
+    long long rssFile = 0, rssShmem = 0, rssBase = -1;
+    off_t offset = 0;
+    size_t length = 0;
+    size_t advance = windowSize - windowOverlap;
+    int i = 0;
+    for ( i=0; i<threads; i++ )
+        {
+        threadSeconds[i] = 0.0;
+        threadMegabytes[i] = 0.0;
+        }
+    windowCount = 0;
+    windowBytes = 0;
+    windowMapSeconds = 0.0;
+    windowWalkSeconds = 0.0;
+    windowUnmapSeconds = 0.0;
+    windowResident = -1;
+    //--- Resident size before windows mapped, subtracted from window resident size ---
+    rssFile = readProcValue( STATUS_PATH, "RssFile:" );
+    rssShmem = readProcValue( STATUS_PATH, "RssShmem:" );
+    if ( ( rssFile >= 0 )&&( rssShmem >= 0 ) ) { rssBase = rssFile + rssShmem; }
+    //--- Create walk threads, not timed, reused by all windows ---
+    walkReuse = 1;
+    status = startWalkThreads( operation, data );
+    if ( status != 0 ) return status;
+    status = readTime( &tsWindows );
+    if( status != 0 )
+        {
+        printf( "\nGet time error ( %s )\n", strerror(errno) );
+        return 3;
+        }
+    for ( offset=0; offset<fileSize; offset+=advance )
+        {
+        length = windowSize;
+        if ( ( fileSize - offset ) < length ) { length = fileSize - offset; }
+        //--- Map window, mmap() time include advice and prefault if used ---
+        readTime( &tsMap );
+        status = mapWindow( offset, length );
+        if ( status != 0 ) return status;
+        readTime( &tsMapped );
+        windowMapSeconds += secondsDelta( &tsMap, &tsMapped );
+        windowsPopulate += populateSeconds;
+        //--- Walk window, walk time from threads release to all threads done ---
+        setWalkRanges( operation );
+        status = releaseWalkThreads();
+        if ( status != 0 ) return status;
+        pthread_barrier_wait( &walkDoneBarrier );
+        readTime( &tsWalk );
+        windowWalkSeconds += secondsDelta( &ts1, &tsWalk );
+        windowBytes += touchedBytes( length );
+        for ( i=0; i<threads; i++ )
+            {
+            threadSeconds[i] += walkContexts[i].seconds;
+            threadMegabytes[i] += walkContexts[i].length / 1048576.0;
+            }
+        //--- Resident size of mapped window, file pages or shared memory pages ---
+        if ( ( windowCount == 0 )&&( rssBase >= 0 ) )
+            {
+            rssFile = readProcValue( STATUS_PATH, "RssFile:" );
+            rssShmem = readProcValue( STATUS_PATH, "RssShmem:" );
+            if ( ( rssFile >= 0 )&&( rssShmem >= 0 ) ) { windowResident = rssFile + rssShmem - rssBase; }
+            }
+        //--- Flush window by msync() before unmap, mapping based flush only ---
+        if ( ( operation == WALK_WRITE )&&( ( wsyncMode == WSYNC_MSYNC )|( wsyncMode == WSYNC_MSYNC_ASYNC ) ) )
+            {
+            readTime( &tsUnmap );
+            status = flushRange( mapOffset, mapLength );
+            if ( status != 0 ) return status;
+            readTime( &tsWalk );
+            flushSeconds += secondsDelta( &tsUnmap, &tsWalk );
+            }
+        //--- Unmap window, munmap() time include TLB shootdown for multi-thread walk ---
+        readTime( &tsUnmap );
+        status = unmapWindow();
+        if ( status != 0 ) return status;
+        readTime( &tsWalk );
+        windowUnmapSeconds += secondsDelta( &tsUnmap, &tsWalk );
+        windowCount++;
+        if ( ( offset + length ) >= fileSize ) break;
+        }
+    //--- Time measurement start point restored, threads exit and join excluded from pass time ---
+    ts1 = tsWindows;
+    readTime( &tsWalk );
+    status = joinWalkThreads( operation );
+    if ( status != 0 ) return status;
+    readTime( &tsUnmap );
+    excludedSeconds += secondsDelta( &tsWalk, &tsUnmap );
+    populateSeconds = windowsPopulate;
+    for ( i=0; i<threads; i++ )
+        {
+        walkContexts[i].seconds = threadSeconds[i];
+        walkContexts[i].mbps = 0.0;
+        if ( threadSeconds[i] > 0.0 ) { walkContexts[i].mbps = threadMegabytes[i] / threadSeconds[i]; }
+        }
+    return 0;
+    }
+
+//--- Handler for output windows string at test progress, if walk by windows ---
+// INPUT:   none, results of last walk by windows used
+//---
+void printWindows()
+    {
+    double mapUs = 0.0, walkUs = 0.0, unmapUs = 0.0;
+    char residentName[PRINT_LIMIT];
+    if ( ( windowSize == 0 )||( windowCount == 0 ) ) return;
+    mapUs = windowMapSeconds * 1000000.0 / windowCount;
+    walkUs = windowWalkSeconds * 1000000.0 / windowCount;
+    unmapUs = windowUnmapSeconds * 1000000.0 / windowCount;
+    snprintf( residentName, PRINT_LIMIT, "n/a" );
+    if ( windowResident >= 0 ) { scratchMemorySize( residentName, windowResident ); }
+    printf( "       windows %-6d mmap %.1f us, walk %.1f us, munmap %.1f us per window, resident %s\n",
+            windowCount, mapUs, walkUs, unmapUs, residentName );
+    }
+
+//--- Helper method for write benchmark point records, at benchmark start ---
+// Sweep and advice=all run benchmark many times, each benchmark numbered.
+// INPUT:   none, command line options variables used
+// OUTPUT:  update benchmarkIndex
+//---
+void outputBenchmark()
+    {
+    benchmarkIndex++;
+    if ( machineFile == NULL ) return;
+    outputInteger( "benchmark", NULL, 0, "file_size", fileSize );
+    outputInteger( "benchmark", NULL, 0, "walk_step", walkStep );
+    outputInteger( "benchmark", NULL, 0, "window", windowSize );
+    outputRecord( "benchmark", NULL, 0, "advice", adviceModes[adviceMode], 1 );
+    outputInteger( "benchmark", NULL, 0, "repeats", repeats );
+    }
+
+//--- Helper method for write latency histogram records ---
+// INPUT:   section, operation, pass = see outputRecord()
+//          histogram = pointer to histogram
+//---
+void outputLatency( char* section, char* operation, int pass, LATENCY_HISTOGRAM* histogram )
+    {
+    if ( ( machineFile == NULL )||( histogram->samples == 0 ) ) return;
+    outputInteger( section, operation, pass, "latency_p50_ns", latencyPercentile( histogram, 0.5 ) );
+    outputInteger( section, operation, pass, "latency_p90_ns", latencyPercentile( histogram, 0.9 ) );
+    outputInteger( section, operation, pass, "latency_p99_ns", latencyPercentile( histogram, 0.99 ) );
+    outputInteger( section, operation, pass, "latency_p999_ns", latencyPercentile( histogram, 0.999 ) );
+    outputInteger( section, operation, pass, "latency_max_ns", histogram->maximum );
+    outputInteger( section, operation, pass, "latency_samples", histogram->samples );
+    }
+
+//--- Helper method for write per pass sample records ---
+// Same values as progress strings of pass, not available values skipped.
+// INPUT:   operation = WALK_WRITE or WALK_READ
+//          rep = pass number, 0-based
+//          slot = index in results logs, same as rep except soak mode
+//---
+void outputPass( int operation, int rep, int slot )
+    {
+    char* passName = operation == WALK_WRITE ? "write" : ( operation == WALK_MIXED ? "mixed" : "read" );
+    int phase = operation == WALK_WRITE ? PHASE_WRITE : PHASE_READ;
+    int pass = rep + 1;
+    char name[OUTPUT_NAME];
+    int i = 0;
+    if ( machineFile == NULL ) return;
+    outputDouble( "pass", passName, pass, "mbps", mbps );
+    outputDouble( "pass", passName, pass, "seconds", seconds );
+    outputDouble( "pass", passName, pass, "pages_per_second", ( ( fileSize + walkStep - 1 ) / walkStep ) / seconds );
+    if ( residentPercent >= 0.0 ) { outputDouble( "pass", passName, pass, "resident_percent", residentPercent ); }
+    if ( populateMode != POPULATE_NONE )
+        {
+        outputDouble( "pass", passName, pass, "prefault_mbps",
+                      operation == WALK_WRITE ? populateWriteLog[slot] : populateReadLog[slot] );
+        outputDouble( "pass", passName, pass, "prefault_seconds", populateSeconds );
+        }
+    if ( operation == WALK_MIXED )
+        {
+        outputDouble( "pass", "mixed_write", pass, "mbps", mixMbps[WALK_WRITE] );
+        outputInteger( "pass", "mixed_write", pass, "accesses", mixOps[WALK_WRITE] );
+        outputLatency( "pass", "mixed_write", pass, &mixLatency[WALK_WRITE] );
+        outputDouble( "pass", "mixed_read", pass, "mbps", mixMbps[WALK_READ] );
+        outputInteger( "pass", "mixed_read", pass, "accesses", mixOps[WALK_READ] );
+        outputLatency( "pass", "mixed_read", pass, &mixLatency[WALK_READ] );
+        }
+    if ( ( operation != WALK_READ )&&( wsyncMode != WSYNC_NONE ) )
+        {
+        outputDouble( "pass", passName, pass, "dirty_mbps", dirtyLog[slot] );
+        outputDouble( "pass", passName, pass, "flush_mbps", flushLog[slot] );
+        outputDouble( "pass", passName, pass, "flush_seconds", flushSeconds );
+        }
+    outputLatency( "pass", passName, pass, &passLatency );
+    if ( ( windowSize != 0 )&&( windowCount != 0 ) )
+        {
+        outputInteger( "pass", passName, pass, "windows", windowCount );
+        outputDouble( "pass", passName, pass, "window_mmap_us", windowMapSeconds * 1000000.0 / windowCount );
+        outputDouble( "pass", passName, pass, "window_walk_us", windowWalkSeconds * 1000000.0 / windowCount );
+        outputDouble( "pass", passName, pass, "window_munmap_us", windowUnmapSeconds * 1000000.0 / windowCount );
+        }
+    for ( i=0; ( perfLeader >= 0 )&&( i<PERF_EVENTS ); i++ )
+        {
+        if ( perfValues[phase][i] < 0 ) continue;
+        snprintf( name, OUTPUT_NAME, "perf_%s", perfNames[i] );
+        outputInteger( "pass", passName, pass, name, perfValues[phase][i] );
+        }
+    for ( i=0; ( kstatMode != 0 )&&( i<KSTAT_FIELDS ); i++ )
+        {
+        if ( kstatDelta[phase][i] == KSTAT_NA ) continue;
+        snprintf( name, OUTPUT_NAME, "kstat_%s", kstatNames[i] );
+        outputInteger( "pass", passName, pass, name, kstatDelta[phase][i] );
+        }
+    if ( ( devstatMode != 0 )&&( devDelta[phase][DEV_READ_IOS] >= 0 ) )
+        {
+        outputInteger( "pass", passName, pass, "dev_read_ios", devDelta[phase][DEV_READ_IOS] );
+        outputInteger( "pass", passName, pass, "dev_read_bytes", devDelta[phase][DEV_READ_SECTORS] * SECTOR_BYTES );
+        outputInteger( "pass", passName, pass, "dev_write_ios", devDelta[phase][DEV_WRITE_IOS] );
+        outputInteger( "pass", passName, pass, "dev_write_bytes", devDelta[phase][DEV_WRITE_SECTORS] * SECTOR_BYTES );
+        outputInteger( "pass", passName, pass, "dev_queue_ms", devDelta[phase][DEV_QUEUE_TICKS] );
+        }
+    }
+
+//--- Run one benchmark pass: create file, map, walk, flush, unmap and delete file ---
+// Whole file mapped before delay if window not used, otherwise
+// windows mapped, walked and unmapped in turn after delay, inside timed interval.
+// File created for this pass or reused, page cache state set before walk.
+// INPUT:   operation = WALK_WRITE or WALK_READ
+//          rep = pass number, index in results logs, soak mode uses first entry
+// OUTPUT:  status, 0=pass OK, otherwise error, messages output to console
+//          update writeLog[] or readLog[], mixedLog[] and both for mixed pass, prefault log, flush logs
+//---
+int runPass( int operation, int rep )
+{
+struct timespec tsFlush, tsFlushed;
+int slot = ( durationSeconds > 0 ) ? 0 : rep;   // results logs entry, soak mode reuses first entry
+double* passLog = writeLog;
+double* prefaultLog = populateWriteLog;
+char* passName = "write";
+int passDelay = writeDelay;
+char passData = '1';
+if ( operation == WALK_READ )
+    {
+    passLog = readLog;
+    prefaultLog = populateReadLog;
+    passName = "read";
+    passDelay = readDelay;
+    passData = 0;
+    }
+else if ( operation == WALK_MIXED )
+    {
+    passLog = mixedLog;
+    prefaultLog = populateReadLog;
+    passName = "mixed";
+    passDelay = readDelay;
+    }
+
+//--- Create temporary file, if not reused ---
+if ( prepareMode == PREPARE_EACH )
+    {
+    status = createTestFile();
+    if ( status != 0 )
+        {
+        return status;
+        }
+    }
+//--- Open file, set page cache state ---
+status = openTestFile();
+if ( status != 0 )
+    {
+    return status;
+    }
+status = setCacheState( operation );
+if ( status != 0 )
+    {
+    return status;
+    }
+//--- Map whole file to virtual address space, if windows not used, pre-touch it if hot ---
+if ( windowSize == 0 )
+    {
+    status = mapWindow( 0, fileSize );
+    if ( status != 0 )
+        {
+        return status;
+        }
+    if ( ( operation == WALK_READ )&&( cacheMode == CACHE_HOT ) )
+        {
+        preTouchMapping();
+        }
+    }
+//--- Write or read delay ---
+status = usleep( passDelay * 1000 );
+if ( status != 0 )
+    {
+    printf( "\nDelay error ( %s )\n", strerror(errno) );
+    return 3;
+    }
+//--- Page cache state check, part of file resident before timed walk ---
+residentPercent = getResidentPercent();
+//--- Buffer page walk by threads, whole mapping or by windows, time measurement start point ---
+setData = passData;
+flushSeconds = 0.0;
+excludedSeconds = 0.0;
+latencyClear( &passLatency );
+kstatBegin( operation == WALK_WRITE ? PHASE_WRITE : PHASE_READ );
+devstatBegin( operation == WALK_WRITE ? PHASE_WRITE : PHASE_READ );
+perfStart( operation == WALK_WRITE ? PHASE_WRITE : PHASE_READ );
+if ( windowSize == 0 )
+    {
+    status = pageWalk( operation, setData );
+    }
+else
+    {
+    status = windowWalk( operation, setData );
+    }
+//--- Counters snapshots between walk and flush excluded from pass time ---
+readTime( &tsFlush );
+perfStop( operation == WALK_WRITE ? PHASE_WRITE : PHASE_READ );
+devstatEnd( operation == WALK_WRITE ? PHASE_WRITE : PHASE_READ );
+kstatEnd( operation == WALK_WRITE ? PHASE_WRITE : PHASE_READ );
+if ( status != 0 )
+    {
+    return status;
+    }
+kstatBegin( PHASE_FLUSH );
+devstatBegin( PHASE_FLUSH );
+perfStart( PHASE_FLUSH );
+readTime( &tsFlushed );
+excludedSeconds += secondsDelta( &tsFlush, &tsFlushed );
+//--- Flush memory to file, write or mixed pass only, msync() by windows done at walk ---
+if ( ( operation != WALK_READ )&&( wsyncMode != WSYNC_NONE )&&
+     ( ( windowSize == 0 )||( ( wsyncMode != WSYNC_MSYNC )&&( wsyncMode != WSYNC_MSYNC_ASYNC ) ) ) )
+    {
+    readTime( &tsFlush );
+    status = flushRange( 0, 0 );
+    if ( status != 0 )
+        {
+        return status;
+        }
+    readTime( &tsFlushed );
+    flushSeconds += secondsDelta( &tsFlush, &tsFlushed );
+    }
+//--- Time measurement stop point, before counters snapshots ---
+status = readTime( &ts2 );
+if( status != 0 )
+    {
+    printf( "\nGet time error ( %s )\n", strerror(errno) );
+    return 3;
+    }
+perfStop( PHASE_FLUSH );
+devstatEnd( PHASE_FLUSH );
+kstatEnd( PHASE_FLUSH );
+//--- Calculate resut megabytes per second ---
+sec = ts2.tv_sec  - ts1.tv_sec;
+ns  = ts2.tv_nsec - ts1.tv_nsec;
+seconds = ns;
+seconds *= TIME_TO_SECONDS;       // convert from nanoseconds to seconds
+seconds += sec;
+seconds -= excludedSeconds;
+megabytes = touchedBytes( fileSize );             // pages not touched by stride not counted
+if ( windowSize != 0 ) { megabytes = windowBytes; }  // overlaps walked again counted
+megabytes /= 1048576.0;           // convert from bytes to megabytes
+mbps = megabytes / seconds;
+passLog[slot] = mbps;
+if ( ( operation == WALK_READ )&&( windowSize != 0 )&&( windowCount != 0 ) )
+    {   // per window times of read pass, window sweep statistics
+    windowMapLog[slot] = windowMapSeconds * 1000000.0 / windowCount;
+    windowWalkLog[slot] = windowWalkSeconds * 1000000.0 / windowCount;
+    windowUnmapLog[slot] = windowUnmapSeconds * 1000000.0 / windowCount;
+    }
+if ( ( operation != WALK_READ )&&( wsyncMode != WSYNC_NONE ) )
+    {   // pass time split to dirtying walk and flush
+    dirtyLog[slot] = 0.0;
+    flushLog[slot] = 0.0;
+    if ( seconds > flushSeconds ) { dirtyLog[slot] = fileSize / 1048576.0 / ( seconds - flushSeconds ); }
+    if ( flushSeconds > 0.0 ) { flushLog[slot] = fileSize / 1048576.0 / flushSeconds; }
+    }
+if ( populateMode != POPULATE_NONE )
+    {
+    prefaultLog[slot] = 0.0;
+    if ( populateSeconds > 0.0 ) { prefaultLog[slot] = fileSize / 1048576.0 / populateSeconds; }
+    }
+if ( operation == WALK_MIXED )
+    {
+    writeLog[slot] = mixMbps[WALK_WRITE];
+    readLog[slot] = mixMbps[WALK_READ];
+    }
+if ( durationSeconds > 0 )
+    {
+    soakProgress( operation, rep );
+    }
+else
+    {
+    handlerProgress( passName, rep, passLog );
+    }
+printPopulate( prefaultLog, slot );
+printCacheState();
+if ( operation == WALK_MIXED ) { printMixed(); }
+if ( operation != WALK_READ ) { printFlush( slot ); }
+if ( operation == WALK_WRITE ) { printWriteBehind(); }
+printCounters( operation == WALK_MIXED ? "mixed ctrs" : "counters", operation == WALK_WRITE ? PHASE_WRITE : PHASE_READ );
+if ( ( operation != WALK_READ )&&( wsyncMode != WSYNC_NONE ) ) { printCounters( "flush ctrs", PHASE_FLUSH ); }
+printKernelCounters( operation == WALK_MIXED ? "mixed kern" : "kernel", operation == WALK_WRITE ? PHASE_WRITE : PHASE_READ );
+if ( ( operation != WALK_READ )&&( wsyncMode != WSYNC_NONE ) ) { printKernelCounters( "flush kern", PHASE_FLUSH ); }
+printDeviceStat( operation == WALK_MIXED ? "mixed dev" : "device", operation == WALK_WRITE ? PHASE_WRITE : PHASE_READ );
+if ( ( operation != WALK_READ )&&( wsyncMode != WSYNC_NONE ) ) { printDeviceStat( "flush dev", PHASE_FLUSH ); }
+if ( operation == WALK_MIXED )
+    {
+    latencyMerge( &writeLatency, &mixLatency[WALK_WRITE] );
+    latencyMerge( &readLatency, &mixLatency[WALK_READ] );
+    }
+else if ( latencyStep != 0 )
+    {
+    printLatency( "latency", &passLatency );
+    latencyMerge( operation == WALK_WRITE ? &writeLatency : &readLatency, &passLatency );
+    }
+printWindows();
+outputPass( operation, rep, slot );
+printWalkThreads();
+printHugePages();
+//--- Unmap whole file if windows not used, close file, delete it if not reused ---
+if ( windowSize == 0 )
+    {
+    status = unmapWindow();
+    if ( status != 0 )
+        {
+        return status;
+        }
+    }
+status = closeTestFile();
+if ( status != 0 )
+    {
+    return status;
+    }
+if ( prepareMode == PREPARE_EACH )
+    {
+    status = removeTestFile();
+    if ( status != 0 )
+        {
+        return status;
+        }
+    }
+return 0;
+}
+
+//--- Run passes of one operation, fixed repeats or until results converge ---
+// Adaptive repeats if precisionTarget above 0: passes run until width of median 95% confidence
+// interval is not above precisionTarget percents of median, warm-up passes detected and excluded,
+// at least repeats passes after warm-up, at most repeatsLimit passes, or budgetSeconds expired.
+// INPUT:   operation = WALK_WRITE or WALK_READ
+// OUTPUT:  status, 0=passes OK, otherwise error, messages output to console
+//          update writePasses, writeWarmup or readPasses, readWarmup
+//---
+int runPhase( int operation )
+{
+struct timespec tsPhase, tsNow;
+double** phaseLog = &writeLog;
+int* phasePasses = &writePasses;
+int* phaseWarmup = &writeWarmup;
+char* phaseName = "write";
+char* stopReason = "repeats limit";
+char widthName[PRINT_LIMIT];
+double width = NAN;
+int rep = 0;
+if ( operation == WALK_READ )
+    {
+    phaseLog = &readLog;
+    phasePasses = &readPasses;
+    phaseWarmup = &readWarmup;
+    phaseName = "read";
+    }
+*phasePasses = 0;
+*phaseWarmup = 0;
+readTime( &tsPhase );
+for ( rep=0; ; rep++ )
+    {
+    if ( ( precisionTarget <= 0.0 )&&( rep >= repeats ) ) break;
+    if ( ( precisionTarget > 0.0 )&&( rep >= repeatsLimit ) ) break;
+    if ( rep >= logCount )
+        {
+        status = reserveLogs( ( rep + 1 ) * 2 );
+        if ( status != 0 )
+            {
+            return status;
+            }
+        }
+    status = runPass( operation, rep );
+    if ( status != 0 )
+        {
+        return status;
+        }
+    *phasePasses = rep + 1;
+    if ( precisionTarget <= 0.0 ) continue;
+    //--- Convergence check, warm-up passes excluded ---
+    *phaseWarmup = detectWarmup( *phaseLog, *phasePasses );
+    if ( ( *phasePasses - *phaseWarmup ) >= repeats )
+        {
+        calculateDistribution( *phaseLog + *phaseWarmup, *phasePasses - *phaseWarmup );
+        width = NAN;
+        if ( resultMedian > 0.0 ) { width = ( resultCiHigh - resultCiLow ) * 100.0 / resultMedian; }
+        if ( width <= precisionTarget )
+            {
+            stopReason = "converged";
+            break;
+            }
+        }
+    readTime( &tsNow );
+    if ( ( budgetSeconds > 0 )&&( secondsDelta( &tsPhase, &tsNow ) >= budgetSeconds ) )
+        {
+        stopReason = "time budget";
+        break;
+        }
+    }
+if ( precisionTarget > 0.0 )
+    {
+    readTime( &tsNow );
+    snprintf( widthName, PRINT_LIMIT, "n/a" );  // CI not calculated if stopped before enough passes
+    if ( !isnan( width ) ) { snprintf( widthName, PRINT_LIMIT, "%.3f%%", width ); }
+    printf( "\n Adaptive %s: %d passes, %d warm-up discarded, CI width %s (target %.3f%%), %s, %.3f s\n",
+            phaseName, *phasePasses, *phaseWarmup, widthName, precisionTarget, stopReason,
+            secondsDelta( &tsPhase, &tsNow ) );
+    outputInteger( "statistics", phaseName, 0, "passes", *phasePasses );
+    outputInteger( "statistics", phaseName, 0, "warmup", *phaseWarmup );
+    if ( !isnan( width ) ) { outputDouble( "statistics", phaseName, 0, "ci_width_percent", width ); }
+    outputRecord( "statistics", phaseName, 0, "stop", stopReason, 1 );
+    }
+return 0;
+}
+
+//--- Run soak: write pass and read pass in turn until duration expired ---
+// Constant memory: results logs first entry reused, streaming statistics and drift detection
+// updated by soakProgress(), summary of interval printed every intervalSeconds.
+// INPUT:   durationSeconds, intervalSeconds
+// OUTPUT:  status, 0=passes OK, otherwise error, messages output to console
+//          update soak statistics, writeMedian, readMedian
+//---
+int runSoak()
+{
+struct timespec tsNow, tsSummary;
+int rep = 0;
+int i = 0;
+for ( i=0; i<2; i++ )
+    {
+    streamClear( &soakTotal[i] );
+    streamClear( &soakInterval[i] );
+    memset( &soakDrift[i], 0, sizeof( DRIFT_STATE ) );
+    streamClear( &soakDrift[i].baseline );
+    }
+soakSummaries = 0;
+readTime( &tsSoak );
+tsSummary = tsSoak;
+for ( rep=0; ; rep++ )
+    {
+    readTime( &tsNow );
+    if ( ( rep > 0 )&&( secondsDelta( &tsSoak, &tsNow ) >= durationSeconds ) ) break;
+    status = runPass( WALK_WRITE, rep );
+    if ( status != 0 )
+        {
+        return status;
+        }
+    status = runPass( WALK_READ, rep );
+    if ( status != 0 )
+        {
+        return status;
+        }
+    readTime( &tsNow );
+    if ( secondsDelta( &tsSummary, &tsNow ) >= intervalSeconds )
+        {
+        soakSummary( 0 );
+        tsSummary = tsNow;
+        }
+    }
+if ( soakInterval[0].count > 0 )
+    {
+    soakSummary( 0 );
+    }
+writeMedian = p2Value( &soakTotal[0].p50 );
+readMedian = p2Value( &soakTotal[1].p50 );
+return 0;
+}
+
+//--- Run benchmark: write passes, read passes, results statistics ---
+// INPUT:   none, command line options variables used
+// OUTPUT:  status, 0=benchmark OK, otherwise error, messages output to console
+//          update writeLog[], readLog[], passes and warm-up counts, writeMedian, readMedian
+//---
+int runBenchmark()
+{
+//--- Allocate and blank log arrays, soak mode uses first entry ---
+int rep = repeats;
+status = reserveLogs( durationSeconds > 0 ? 1 : repeats );
+if ( status != 0 )
+    {
+    return status;
+    }
+for ( rep=0; rep<logCount; rep++ )
+	{
+	readLog[rep] = 0.0;
+	writeLog[rep] = 0.0;
+	}
+
+latencyClear( &writeLatency );
+latencyClear( &readLatency );
+outputBenchmark();
+
+//--- Prepare file once, if reused by all passes ---
+if ( prepareMode != PREPARE_EACH )
+    {
+    readTime( &ts1 );
+    status = createTestFile();
+    if ( status != 0 )
+        {
+        return status;
+        }
+    readTime( &ts2 );
+    printf( "\nFile prepared by %s, %.3f ms\n", prepareModes[prepareMode], secondsDelta( &ts1, &ts2 ) * 1000.0 );
+    }
+
+//--- Cycle for measurement repeats ---
+printf( "\nStart benchmarking.\n" );
+printf( "Pass | Operation | MBPS     | Median   | Average  | Minimum  | Maximum\n" );
+printf( "-------------------------------------------------------------------------\n\n" );
+
+//--- Cycle for WRITE --------------------------------------------------
+
+if ( durationSeconds > 0 )
+    {
+    status = runSoak();
+    if ( status != 0 )
+        {
+        return status;
+        }
+    }
+else if ( rwmix >= 0 )
+    {
+    for ( rep=0; rep<repeats; rep++ )
+        {
+        status = runPass( WALK_MIXED, rep );
+        if ( status != 0 )
+            {
+            return status;
+            }
+        }
+    }
+else
+    {
+    status = runPhase( WALK_WRITE );
+    if ( status != 0 )
+        {
+        return status;
+        }
+
+//--- Cycle for READ ---------------------------------------------------
+
+    printf( "\n" );
+    status = runPhase( WALK_READ );
+    if ( status != 0 )
+        {
+        return status;
+        }
+    }
+
+printf( "\n-------------------------------------------------------------------------\n" );
+
+//--- Delete file, if reused by all passes ---
+if ( prepareMode != PREPARE_EACH )
+    {
+    status = removeTestFile();
+    if ( status != 0 )
+        {
+        return status;
+        }
+    }
+
+//--- Print summary info -----------------------------------------------
+
+//--- Soak mode totals, streaming statistics ---
+if ( durationSeconds > 0 )
+    {
+    soakSummary( 1 );
+    if ( latencyStep != 0 )
+        {
+        printf( "\nWrite page latency, all passes:\n" );
+        printLatency( "latency", &writeLatency );
+        outputLatency( "statistics", "write", 0, &writeLatency );
+        printf( "\nRead page latency, all passes:\n" );
+        printLatency( "latency", &readLatency );
+        outputLatency( "statistics", "read", 0, &readLatency );
+        }
+    return 0;
+    }
+
+//--- Mixed walk statistics, writes and reads measured while both run ---
+if ( rwmix >= 0 )
+    {
+    printf( "\nMixed statistics (MBPS, %d%% reads, %s distribution):\n", rwmix, distributionModes[distribution] );
+    calculateDistribution( mixedLog, repeats );
+    handlerOutput( opb_list, OPB_TABS );
+    outputBlock( "statistics", "mixed", opb_list );
+    printPagesRate();
+    printf( "\nMixed write statistics (MBPS, time of write accesses):\n" );
+    calculateDistribution( writeLog, repeats );
+    handlerOutput( opb_list, OPB_TABS );
+    outputBlock( "statistics", "mixed_write", opb_list );
+    writeMedian = resultMedian;
+    printf( "\nMixed read statistics (MBPS, time of read accesses):\n" );
+    calculateDistribution( readLog, repeats );
+    handlerOutput( opb_list, OPB_TABS );
+    outputBlock( "statistics", "mixed_read", opb_list );
+    readMedian = resultMedian;
+    printf( "\nMixed write latency, all passes:\n" );
+    printLatency( "latency", &writeLatency );
+    outputLatency( "statistics", "mixed_write", 0, &writeLatency );
+    printf( "\nMixed read latency, all passes:\n" );
+    printLatency( "latency", &readLatency );
+    outputLatency( "statistics", "mixed_read", 0, &readLatency );
+    return 0;
+    }
+
+//--- Print output parameters, read results ---
+printf( "\nWrite statistics (MBPS):\n" );
+calculateDistribution( writeLog + writeWarmup, writePasses - writeWarmup );
+handlerOutput( opb_list, OPB_TABS );
+outputBlock( "statistics", "write", opb_list );
+printPagesRate();
+writeMedian = resultMedian;
+if ( populateMode != POPULATE_NONE )
+    {
+    printf( "\nWrite prefault statistics (MBPS):\n" );
+    calculateDistribution( populateWriteLog + writeWarmup, writePasses - writeWarmup );
+    handlerOutput( opb_list, OPB_TABS );
+    outputBlock( "statistics", "write_prefault", opb_list );
+    }
+if ( latencyStep != 0 )
+    {
+    printf( "\nWrite page latency, all passes:\n" );
+    printLatency( "latency", &writeLatency );
+    outputLatency( "statistics", "write", 0, &writeLatency );
+    }
+if ( wsyncMode != WSYNC_NONE )
+    {
+    printf( "\nWrite dirtying walk statistics (MBPS):\n" );
+    calculateDistribution( dirtyLog + writeWarmup, writePasses - writeWarmup );
+    handlerOutput( opb_list, OPB_TABS );
+    outputBlock( "statistics", "write_dirty", opb_list );
+    printf( "\nWrite flush statistics (MBPS):\n" );
+    calculateDistribution( flushLog + writeWarmup, writePasses - writeWarmup );
+    handlerOutput( opb_list, OPB_TABS );
+    outputBlock( "statistics", "write_flush", opb_list );
+    }
+
+//--- Print output parameters, read results ---
+printf( "\nRead statistics (MBPS):\n" );
+calculateDistribution( readLog + readWarmup, readPasses - readWarmup );
+handlerOutput( opb_list, OPB_TABS );
+outputBlock( "statistics", "read", opb_list );
+printPagesRate();
+readMedian = resultMedian;
+if ( populateMode != POPULATE_NONE )
+    {
+    printf( "\nRead prefault statistics (MBPS):\n" );
+    calculateDistribution( populateReadLog + readWarmup, readPasses - readWarmup );
+    handlerOutput( opb_list, OPB_TABS );
+    outputBlock( "statistics", "read_prefault", opb_list );
+    }
+if ( latencyStep != 0 )
+    {
+    printf( "\nRead page latency, all passes:\n" );
+    printLatency( "latency", &readLatency );
+    outputLatency( "statistics", "read", 0, &readLatency );
+    }
+return 0;
+}
+
+//--- Run stride sweep: benchmark for geometric series of page walk strides ---
+// INPUT:   none, command line options variables used
+// OUTPUT:  status, 0=sweep OK, otherwise error, messages output to console
+//---
+int runStrideSweep()
+{
+int i = 0;
+int count = 0;
+size_t stride = 0;
+char strideName[PRINT_LIMIT];
+double stepsPerMegabyte = 0.0;
+
+//--- Benchmark for each stride, stride limited by file or window size and threads ---
+for ( stride=STRIDE_MIN; ( stride<=STRIDE_MAX )&&( count<SWEEP_MAX )&&( ( fileSize / stride ) >= threads )&&
+      ( ( windowSize == 0 )||( ( windowSize / stride ) >= threads ) ); stride*=SWEEP_FACTOR )
+    {
+    walkStep = stride;
+    printf( "\n\nPage walk stride = " );
+    printMemorySize( walkStep );
+    printf( "\n" );
+    status = runBenchmark();
+    if ( status != 0 ) return status;
+    sweepPoints[count] = stride;
+    sweepWriteLog[count] = writeMedian;
+    sweepReadLog[count] = readMedian;
+    count++;
+    }
+
+//--- Throughput versus stride table ---
+printf( "\nStride sweep summary (median):\n" );
+printf( "Stride       | Write MBPS | Read MBPS  | Write steps/s | Read steps/s\n" );
+printf( "-----------------------------------------------------------------------\n" );
+for ( i=0; i<count; i++ )
+    {
+    scratchMemorySize( strideName, sweepPoints[i] );
+    stepsPerMegabyte = 1048576.0 / sweepPoints[i];
+    printf( " %-13s%10.3f%13.3f%16.0f%15.0f\n", strideName, sweepWriteLog[i], sweepReadLog[i],
+            sweepWriteLog[i] * stepsPerMegabyte, sweepReadLog[i] * stepsPerMegabyte );
+    }
+printf( "-----------------------------------------------------------------------\n" );
+return 0;
+}
+
+//--- Run size sweep: benchmark for geometric series of file sizes ---
+// Sizes from minimum up to multiple of physical RAM, limited by maximum file size,
+// and by maximum mapping size if window not used.
+// Knee is first size with read speed below KNEE_RATIO of previous peak
+// and not restored above it at larger sizes,
+// page cache capacity reference is MemAvailable from /proc/meminfo.
+// INPUT:   none, command line options variables used
+// OUTPUT:  status, 0=sweep OK, otherwise error, messages output to console
+//---
+int runSizeSweep()
+{
+int i = 0, j = 0;
+int count = 0;
+int knee = -1;
+int cacheMark = -1;
+off_t size = 0;
+off_t sizeStart = FILE_SIZE_MIN;
+off_t sizeStop = FILE_SIZE_MAX;
+off_t savedSize = fileSize;
+long long memTotal = readProcValue( MEMINFO_PATH, "MemTotal:" );
+long long memAvailable = readProcValue( MEMINFO_PATH, "MemAvailable:" );
+long long memCached = readProcValue( MEMINFO_PATH, "Cached:" );
+double peak = 0.0;
+double nsPerMegabyte = 0.0;
+char sizeName[PRINT_LIMIT];
+
+//--- Sizes range, start must be valid for threads and huge pages ---
+if ( sizeStart < ( walkStep * threads ) ) { sizeStart = walkStep * threads; }
+if ( sizeStart < hugePageSize ) { sizeStart = hugePageSize; }
+if ( ( windowSize == 0 )&&( sizeStop > MAP_SIZE_MAX ) ) { sizeStop = MAP_SIZE_MAX; }
+if ( ( memTotal > 0 )&&( ( memTotal * ramFactor ) < sizeStop ) ) { sizeStop = memTotal * ramFactor; }
+printf( "\nPhysical memory  = " );
+printMemorySize( memTotal > 0 ? memTotal : 0 );
+printf( "\nAvailable memory = " );
+printMemorySize( memAvailable > 0 ? memAvailable : 0 );
+printf( "\nPage cache now   = " );
+printMemorySize( memCached > 0 ? memCached : 0 );
+printf( "\nSweep from " );
+printMemorySize( sizeStart );
+printf( " to " );
+printMemorySize( sizeStop );
+printf( "\n" );
+
+//--- Benchmark for each size ---
+for ( size=sizeStart; ( size<=sizeStop )&&( count<SWEEP_MAX ); size*=SWEEP_FACTOR )
+    {
+    fileSize = size;
+    printf( "\n\nFile size = " );
+    printMemorySize( fileSize );
+    printf( "\n" );
+    status = runBenchmark();
+    if ( status != 0 ) return status;
+    sweepPoints[count] = size;
+    sweepWriteLog[count] = writeMedian;
+    sweepReadLog[count] = readMedian;
+    count++;
+    }
+fileSize = savedSize;
+
+//--- Detect knee: drop below part of previous peak, sustained for all next sizes ---
+for ( i=0; i<count; i++ )
+    {
+    if ( ( knee < 0 )&&( i > 0 )&&( sweepReadLog[i] < ( peak * KNEE_RATIO ) ) )
+        {
+        knee = i;
+        for ( j=i; j<count; j++ )
+            {
+            if ( sweepReadLog[j] >= ( peak * KNEE_RATIO ) ) { knee = -1; }
+            }
+        }
+    if ( sweepReadLog[i] > peak ) { peak = sweepReadLog[i]; }
+    if ( ( memAvailable > 0 )&&( sweepPoints[i] <= memAvailable ) ) { cacheMark = i; }
+    }
+
+//--- Throughput and latency versus size table ---
+nsPerMegabyte = walkStep / 1048576.0 * 1000000000.0;
+printf( "\nSize sweep summary (median):\n" );
+printf( "Size         | Write MBPS | Read MBPS  | Write ns/step | Read ns/step | Mark\n" );
+printf( "--------------------------------------------------------------------------------\n" );
+for ( i=0; i<count; i++ )
+    {
+    scratchMemorySize( sizeName, sweepPoints[i] );
+    printf( " %-13s%10.3f%13.3f%16.1f%15.1f   ", sizeName, sweepWriteLog[i], sweepReadLog[i],
+            sweepWriteLog[i] > 0.0 ? nsPerMegabyte / sweepWriteLog[i] : 0.0,
+            sweepReadLog[i] > 0.0 ? nsPerMegabyte / sweepReadLog[i] : 0.0 );
+    if ( i == cacheMark ) { printf( "<- page cache capacity " ); }
+    if ( i == knee ) { printf( "<- knee" ); }
+    printf( "\n" );
+    }
+printf( "--------------------------------------------------------------------------------\n" );
+if ( knee < 0 )
+    {
+    printf( "Knee not detected, all sizes fit page cache or sweep too short.\n" );
+    }
+return 0;
+}
+
+//--- Run window sweep: benchmark for geometric series of mapping windows ---
+// Windows from page or huge page size up to file size, limited by maximum mapping size.
+// Per-window mmap(), walk and munmap() times are medians of read passes,
+// resident size is mapped window pages resident during read walk.
+// INPUT:   none, command line options variables used
+// OUTPUT:  status, 0=sweep OK, otherwise error, messages output to console
+//---
+int runWindowSweep()
+{
+int i = 0;
+int count = 0;
+size_t window = pageSize;
+size_t windowStop = MAP_SIZE_MAX;
+size_t savedWindow = windowSize;
+double windowSeconds = 0.0;
+char windowName[PRINT_LIMIT];
+char residentName[PRINT_LIMIT];
+
+//--- Windows range, start must be valid for threads, huge pages and overlap ---
+if ( window < hugePageSize ) { window = hugePageSize; }
+while ( ( window < ( walkStep * threads ) )||( window <= windowOverlap ) ) { window *= SWEEP_FACTOR; }
+if ( fileSize < windowStop ) { windowStop = fileSize; }
+
+//--- Benchmark for each window ---
+for ( ; ( window<=windowStop )&&( count<SWEEP_MAX ); window*=SWEEP_FACTOR )
+    {
+    windowSize = window;
+    printf( "\n\nMapping window = " );
+    printMemorySize( windowSize );
+    printf( "\n" );
+    status = runBenchmark();
+    if ( status != 0 ) return status;
+    sweepPoints[count] = window;
+    sweepWriteLog[count] = writeMedian;
+    sweepReadLog[count] = readMedian;
+    sweepWindows[count] = windowCount;
+    sweepResident[count] = windowResident;
+    calculateStatistics(  windowMapLog + readWarmup, readPasses - readWarmup,
+                         &resultMedian, &resultAverage,
+                         &resultMinimum, &resultMaximum );
+    sweepMapLog[count] = resultMedian;
+    calculateStatistics(  windowWalkLog + readWarmup, readPasses - readWarmup,
+                         &resultMedian, &resultAverage,
+                         &resultMinimum, &resultMaximum );
+    sweepWalkLog[count] = resultMedian;
+    calculateStatistics(  windowUnmapLog + readWarmup, readPasses - readWarmup,
+                         &resultMedian, &resultAverage,
+                         &resultMinimum, &resultMaximum );
+    sweepUnmapLog[count] = resultMedian;
+    count++;
+    }
+windowSize = savedWindow;
+
+//--- Syscalls cost versus resident memory table ---
+printf( "\nWindow sweep summary (median, per window times of read passes):\n" );
+printf( "Window       | Windows | Write MBPS | Read MBPS  | mmap us  | walk us    | munmap us | Syscall | Resident\n" );
+printf( "----------------------------------------------------------------------------------------------------------\n" );
+for ( i=0; i<count; i++ )
+    {
+    scratchMemorySize( windowName, sweepPoints[i] );
+    snprintf( residentName, PRINT_LIMIT, "n/a" );
+    if ( sweepResident[i] >= 0 ) { scratchMemorySize( residentName, sweepResident[i] ); }
+    windowSeconds = sweepMapLog[i] + sweepWalkLog[i] + sweepUnmapLog[i];
+    printf( " %-13s%8d%13.3f%13.3f%11.1f%13.1f%12.1f%8.1f%%   %s\n",
+            windowName, sweepWindows[i], sweepWriteLog[i], sweepReadLog[i],
+            sweepMapLog[i], sweepWalkLog[i], sweepUnmapLog[i],
+            windowSeconds > 0.0 ? ( sweepMapLog[i] + sweepUnmapLog[i] ) * 100.0 / windowSeconds : 0.0,
+            residentName );
+    }
+printf( "----------------------------------------------------------------------------------------------------------\n" );
+printf( "Syscall = mmap() and munmap() part of window time, munmap() include TLB shootdown.\n" );
+return 0;
+}
+
+//---------- Start conditions, benchmark run and test plan ---------------------
+
+//--- Detect platform, print and check start conditions, open performance counters ---
+// Called once for command line options, for each scenario if test plan used.
+// INPUT:   none, command line or scenario options variables used
+// OUTPUT:  status, 0=start conditions valid, 1=bad parameter, messages output to console
+//---
+int checkConfiguration()
+{
+int i = 0;
+char* endPointer = NULL;
+
+//--- Detect target file system and page walk step, select page walk kernel ---
+detectPageMode();
+devNameBuffer[0] = 0;
+if ( devstatMode != 0 ) { detectDevice(); }
+kernelStatus = selectKernel();
+timerStatus = selectTimer();
+
+//--- Title string for test conditions ---
+printf( "Start conditions:\n" );
+
+//--- Print transit (config) parameters ---
 handlerOutput( tpb_list, IPB_TABS );
+outputBlock( "condition", NULL, tpb_list );
+if ( timerStatus == 0 )
+    {
+    printTimer();
+    outputInteger( "condition", NULL, 0, "timer_overhead_ns", timerOverhead );
+    outputInteger( "condition", NULL, 0, "timer_resolution_ns", timerResolution );
+    if ( timerMode == TIMER_TSC ) { outputDouble( "condition", NULL, 0, "tsc_mhz", tscFrequency / 1000000.0 ); }
+    }
 
 //--- Check start parameters validity and compatibility ---
 if ( ( fileSize < FILE_SIZE_MIN ) | ( fileSize > FILE_SIZE_MAX ) )
     {
-    printf("\nBAD PARAMETER: file size must be from " );
-    printMemorySize( FILE_SIZE_MIN );
-    printf(" to ");
-    printMemorySize( FILE_SIZE_MAX );
+    printf("\nBAD PARAMETER: file size must be from " );
+    printMemorySize( FILE_SIZE_MIN );
+    printf(" to ");
+    printMemorySize( FILE_SIZE_MAX );
+    printf( "\n" );
+    return 1;
+    }
+if ( ( windowSize == 0 )&&( sweepMode != SWEEP_WINDOW )&&( fileSize > MAP_SIZE_MAX ) )
+    {
+    printf("\nBAD PARAMETER: file above " );
+    printMemorySize( MAP_SIZE_MAX );
+    printf(" can not be mapped at once, window required\n" );
+    return 1;
+    }
+if ( ( windowSize != 0 )&&( ( windowSize > MAP_SIZE_MAX ) | ( ( windowSize % pageSize ) != 0 ) ) )
+    {
+    printf("\nBAD PARAMETER: window must be multiple of page size " );
+    printMemorySize( pageSize );
+    printf(", up to ");
+    printMemorySize( MAP_SIZE_MAX );
+    printf( "\n" );
+    return 1;
+    }
+if ( ( writeDelay < DELAY_MIN ) | ( writeDelay > DELAY_MAX ) )
+    {
+    printf("\nBAD PARAMETER: Write delay must be from %d to %d milliseconds\n", DELAY_MIN, DELAY_MAX );
+    return 1;
+    }
+if ( ( readDelay < DELAY_MIN ) | ( readDelay > DELAY_MAX ) )
+    {
+    printf("\nBAD PARAMETER: Read delay must be from %d to %d milliseconds\n", DELAY_MIN, DELAY_MAX );
+    return 1;
+    }
+if ( ( repeats < REPEATS_MIN ) | ( repeats > REPEATS_MAX ) )
+    {
+    printf("\nBAD PARAMETER: Repeats must be from %d to %d times\n", REPEATS_MIN, REPEATS_MAX );
+    return 1;
+    }
+precisionTarget = strtod( precisionString, &endPointer );
+if ( ( endPointer == precisionString )||( *endPointer != 0 )||
+     ( !( precisionTarget >= 0.0 ) )||( precisionTarget > PRECISION_MAX ) )
+    {
+    printf("\nBAD PARAMETER: Precision must be from 0 to %.0f percents\n", PRECISION_MAX );
+    return 1;
+    }
+if ( ( precisionTarget > 0.0 )&&( repeats < REPEATS_ADAPTIVE ) )
+    {
+    printf("\nBAD PARAMETER: Repeats must be at least %d for precision target\n", REPEATS_ADAPTIVE );
+    return 1;
+    }
+if ( ( precisionTarget > 0.0 )&&( ( repeatsLimit < repeats ) | ( repeatsLimit > REPEATS_MAX ) ) )
+    {
+    printf("\nBAD PARAMETER: Repeats limit must be from repeats to %d\n", REPEATS_MAX );
+    return 1;
+    }
+if ( ( budgetSeconds < 0 ) | ( budgetSeconds > BUDGET_MAX ) )
+    {
+    printf("\nBAD PARAMETER: Time budget must be from 0 to %d seconds\n", BUDGET_MAX );
+    return 1;
+    }
+if ( ( durationSeconds < 0 ) | ( durationSeconds > DURATION_MAX ) )
+    {
+    printf("\nBAD PARAMETER: Duration must be from 0 to %d seconds\n", DURATION_MAX );
+    return 1;
+    }
+if ( ( intervalSeconds < 1 ) | ( intervalSeconds > INTERVAL_MAX ) )
+    {
+    printf("\nBAD PARAMETER: Interval must be from 1 to %d seconds\n", INTERVAL_MAX );
+    return 1;
+    }
+if ( ( durationSeconds > 0 )&&( ( sweepMode != SWEEP_NONE )||( adviceMode == ADVICE_ALL )||( precisionTarget > 0.0 ) ) )
+    {
+    printf("\nBAD PARAMETER: Duration not compatible with sweep, advice=all and precision\n" );
+    return 1;
+    }
+if ( ( rwmix < -1 ) | ( rwmix > 100 ) )
+    {
+    printf("\nBAD PARAMETER: Mixed reads percentage must be from 0 to 100, -1 = not used\n" );
+    return 1;
+    }
+if ( ( skew < SKEW_MIN ) | ( skew > SKEW_MAX ) )
+    {
+    printf("\nBAD PARAMETER: Skew must be from %d to %d percents\n", SKEW_MIN, SKEW_MAX );
+    return 1;
+    }
+if ( ( rwmix >= 0 )&&( ( windowSize != 0 )||( writeBehind != 0 )||( sweepMode != SWEEP_NONE )||
+     ( adviceMode == ADVICE_ALL )||( precisionTarget > 0.0 )||( durationSeconds > 0 ) ) )
+    {
+    printf("\nBAD PARAMETER: rwmix not compatible with window, writebehind, sweep, advice=all, precision and duration\n" );
+    return 1;
+    }
+if ( ( outlierLimit < 0 ) | ( outlierLimit > OUTLIERS_MAX ) )
+    {
+    printf("\nBAD PARAMETER: Outliers limit must be from 0 to %d\n", OUTLIERS_MAX );
+    return 1;
+    }
+if ( ( threads < THREADS_MIN ) | ( threads > THREADS_MAX ) )
+    {
+    printf("\nBAD PARAMETER: Threads must be from %d to %d\n", THREADS_MIN, THREADS_MAX );
+    return 1;
+    }
+if ( kernelStatus != 0 )
+    {
+    printf("\nBAD PARAMETER: page walk kernel not supported by this CPU or build\n" );
+    return 1;
+    }
+if ( ( countersMode < 0 ) | ( countersMode > 1 ) )
+    {
+    printf("\nBAD PARAMETER: counters must be 0 or 1\n" );
+    return 1;
+    }
+if ( ( kstatMode < 0 ) | ( kstatMode > 1 ) )
+    {
+    printf("\nBAD PARAMETER: kstat must be 0 or 1\n" );
+    return 1;
+    }
+if ( ( devstatMode < 0 ) | ( devstatMode > 1 ) )
+    {
+    printf("\nBAD PARAMETER: devstat must be 0 or 1\n" );
+    return 1;
+    }
+if ( timerStatus != 0 )
+    {
+    printf("\nBAD PARAMETER: timer tsc requires invariant TSC, not supported by this CPU or build\n" );
+    return 1;
+    }
+if ( ( pageMode == PAGES_HUGETLB )&&( fsMagic != HUGETLBFS_MAGIC ) )
+    {
+    printf("\nBAD PARAMETER: hugetlb page mode requires file at hugetlbfs mount\n" );
+    return 1;
+    }
+if ( ( hugePageSize > 0 )&&( ( fileSize % hugePageSize ) != 0 ) )
+    {
+    printf("\nBAD PARAMETER: file size must be multiple of huge page size " );
+    printMemorySize( hugePageSize );
+    printf( "\n" );
+    return 1;
+    }
+if ( ( hugePageSize > 0 )&&( ( windowSize % hugePageSize ) != 0 ) )
+    {
+    printf("\nBAD PARAMETER: window must be multiple of huge page size " );
+    printMemorySize( hugePageSize );
+    printf( "\n" );
+    return 1;
+    }
+if ( ( latencyStep < 0 ) | ( latencyStep > LATENCY_STEP_MAX ) )
+    {
+    printf("\nBAD PARAMETER: latency sampling must be from 0 to %d walk steps\n", LATENCY_STEP_MAX );
+    return 1;
+    }
+if ( ( cacheMode == CACHE_DROP )&&( geteuid() != 0 ) )
+    {
+    printf("\nBAD PARAMETER: drop caches mode requires privileged run\n" );
+    return 1;
+    }
+if ( ( writeBehind != 0 )&&( ( ( writeBehind % pageSize ) != 0 ) |
+                              ( ( hugePageSize > 0 )&&( ( writeBehind % hugePageSize ) != 0 ) ) ) )
+    {
+    printf("\nBAD PARAMETER: write-behind chunk must be multiple of page size " );
+    printMemorySize( hugePageSize > 0 ? hugePageSize : pageSize );
+    printf( "\n" );
+    return 1;
+    }
+if ( ( writeBehind != 0 )&&( ( threads != 1 ) | ( addressing != ADDR_SEQUENTIAL ) | ( windowSize != 0 ) ) )
+    {
+    printf("\nBAD PARAMETER: write-behind requires single thread sequential walk without window\n" );
+    return 1;
+    }
+if ( ( windowOverlap != 0 )&&( ( ( windowSize == 0 )&&( sweepMode != SWEEP_WINDOW ) ) |
+                                ( ( windowSize != 0 )&&( windowOverlap >= windowSize ) ) |
+                                ( ( windowOverlap % pageSize ) != 0 ) ) )
+    {
+    printf("\nBAD PARAMETER: overlap must be multiple of page size " );
+    printMemorySize( pageSize );
+    printf(", below window size\n" );
+    return 1;
+    }
+if ( ( hugePageSize > 0 )&&( ( windowOverlap % hugePageSize ) != 0 ) )
+    {
+    printf("\nBAD PARAMETER: overlap must be multiple of huge page size " );
+    printMemorySize( hugePageSize );
     printf( "\n" );
     return 1;
     }
-if ( ( wsyncMode != WSYNC_NO ) & ( wsyncMode != WSYNC_YES ) )
+if ( ( walkStride != 0 )&&( ( walkStride < STRIDE_MIN ) | ( walkStride > STRIDE_MAX ) |
+                             ( ( walkStride % CACHE_LINE ) != 0 ) ) )
     {
-    printf("\nBAD PARAMETER: Write synchronization option must be %d or %d \n", WSYNC_NO, WSYNC_YES );
+    printf("\nBAD PARAMETER: stride must be multiple of %d bytes, from ", CACHE_LINE );
+    printMemorySize( STRIDE_MIN );
+    printf(" to ");
+    printMemorySize( STRIDE_MAX );
+    printf( "\n" );
     return 1;
     }
-if ( ( writeDelay < DELAY_MIN ) | ( writeDelay > DELAY_MAX ) )
+if ( ( ramFactor < RAM_FACTOR_MIN ) | ( ramFactor > RAM_FACTOR_MAX ) )
     {
-    printf("\nBAD PARAMETER: Write delay must be from %d to %d milliseconds\n", DELAY_MIN, DELAY_MAX );
+    printf("\nBAD PARAMETER: RAM factor must be from %d to %d\n", RAM_FACTOR_MIN, RAM_FACTOR_MAX );
     return 1;
     }
-if ( ( readDelay < DELAY_MIN ) | ( readDelay > DELAY_MAX ) )
+if ( ( sweepMode != SWEEP_NONE )&&( adviceMode == ADVICE_ALL ) )
     {
-    printf("\nBAD PARAMETER: Read delay must be from %d to %d milliseconds\n", DELAY_MIN, DELAY_MAX );
+    printf("\nBAD PARAMETER: sweep and advice=all can not be used together\n" );
     return 1;
     }
-if ( ( repeats < REPEATS_MIN ) | ( repeats > REPEATS_MAX ) )
+if ( ( sweepMode != SWEEP_SIZE )&&( threads > ( fileSize / walkStep ) ) )
     {
-    printf("\nBAD PARAMETER: Repeats must be from %d to %d times\n", REPEATS_MIN, REPEATS_MAX );
+    printf("\nBAD PARAMETER: Threads count must not exceed number of pages in the file\n" );
     return 1;
     }
-
-//--- Wait for key (Y/N) with list of start parameters ---
-printf("\nStart? (Y/N)" );
-int key = 0;
-key = getchar();
-key = tolower(key);
-if ( key != 'y' )
+if ( ( windowSize != 0 )&&( threads > ( windowSize / walkStep ) ) )
     {
-    printf( "Test skipped.\n" );
-    return 3;
+    printf("\nBAD PARAMETER: Threads count must not exceed number of pages in the window\n" );
+    return 1;
     }
 
-//--- Blank log arrays ---
-int rep = repeats;
-for ( rep=0; rep<REPEATS_MAX; rep++ )
-	{
-	readLog[rep] = 0.0;
-	writeLog[rep] = 0.0;
-	}
-
-//--- Cycle for measurement repeats ---
-printf( "\nStart benchmarking.\n" );
-printf( "Pass | Operation | MBPS     | Median   | Average  | Minimum  | Maximum\n" );
-printf( "-------------------------------------------------------------------------\n\n" );
-
-//--- Cycle for WRITE --------------------------------------------------
+//--- Detect CPUs for walk threads pinning, open performance counters ---
+detectWalkCpus();
+for ( i=0; i<PERF_EVENTS; i++ ) { perfHandles[i] = -1; }
+perfLeader = -1;
+if ( countersMode != 0 ) { perfOpen(); }
+return 0;
+}
 
-for ( rep=0; rep<repeats; rep++ )
+//--- Run benchmark for checked start conditions: single advice, all advices cycle or sweep ---
+// INPUT:   none, command line or scenario options variables used
+// OUTPUT:  status, 0=benchmark OK, otherwise error, messages output to console
+//          update writeMedian, readMedian for single benchmark
+//---
+int runConfiguration()
+{
+int i = 0;
+if ( sweepMode == SWEEP_STRIDE )
+    {
+    status = runStrideSweep();
+    if ( status != 0 ) return status;
+    }
+else if ( sweepMode == SWEEP_SIZE )
+    {
+    status = runSizeSweep();
+    if ( status != 0 ) return status;
+    }
+else if ( sweepMode == SWEEP_WINDOW )
+    {
+    status = runWindowSweep();
+    if ( status != 0 ) return status;
+    }
+else if ( adviceMode != ADVICE_ALL )
+    {
+    status = runBenchmark();
+    if ( status != 0 ) return status;
+    }
+else
     {
-    //--- Start create temporary file, allocate memory ---
-    bufSize = BUFFER_SIZE;
-    diskData = memalign ( bufAlign, bufSize );
-    if ( diskData<=0 )
+    for ( i=ADVICE_NONE; i<ADVICE_ALL; i++ )
         {
-        printf( "%s ( %s )\n", "Memory allocation failed", strerror(errno) );
-        return 3;
+        adviceMode = i;
+        printf( "\n\nAccess advice = %s\n", adviceModes[i] );
+        status = runBenchmark();
+        if ( status != 0 ) return status;
+        adviceWriteLog[i] = writeMedian;
+        adviceReadLog[i] = readMedian;
         }
-    //--- Fill memory ---
-    setData = '0';
-    memset ( diskData, setData, bufSize );
-    //--- Create file ---
-    fileHandle = open ( filePath, createFlags );    // open (create) file
-    if ( fileHandle <= 0 )
+    adviceMode = ADVICE_ALL;
+    printf( "\nAccess advices summary (median MBPS):\n" );
+    printf( "Advice       | Write      | Read\n" );
+    printf( "-----------------------------------------\n" );
+    for ( i=ADVICE_NONE; i<ADVICE_ALL; i++ )
         {
-        printf ( "\nFile create error: %s ( %s )\n", filePath, strerror(errno) );
-        return 3;
+        printf( " %-13s%10.3f%13.3f\n", adviceModes[i], adviceWriteLog[i], adviceReadLog[i] );
         }
-    //--- Write file from buffer ---
-    ssize_t addSize = 0;
-    ssize_t outSize = 0;
-    ssize_t count = bufSize;
-    while ( addSize < fileSize )
+    printf( "-----------------------------------------\n" );
+    }
+return 0;
+}
+
+//--- Helper method for save options variables, defaults for test plan scenarios ---
+// INPUT:   parse_control = options list, null-terminated
+//          saved = array for values, PLAN_OPTIONS entries
+//---
+void saveOptions( OPTION_ENTRY parse_control[], OPTION_VALUE saved[] )
+    {
+    int i = 0;
+    for ( i=0; ( parse_control[i].name!=NULL )&&( i<PLAN_OPTIONS ); i++ )
         {
-        if ( ( fileSize - addSize ) < bufSize )
-            {
-            count = fileSize - addSize;
-            }
-        outSize = write( fileHandle, diskData, count );
-        if ( outSize > 0 )
-            {
-            addSize += outSize;
-            }
-        else if ( outSize == 0 )
-            {
-            printf( "\nUnexpected zero size write error: %s", filePath );
-            return 3;
-            }
-        else
+        switch( parse_control[i].routine )
             {
-            printf ( "\nFile write error: %s ( %s )\n", filePath, strerror(errno) );
-            return 3;
+            case INTPARM:
+            case SELPARM:
+                saved[i].intValue = *(int*)parse_control[i].data;
+                break;
+            case MEMPARM:
+                saved[i].memValue = *(size_t*)parse_control[i].data;
+                break;
+            case OFFPARM:
+                saved[i].offValue = *(off_t*)parse_control[i].data;
+                break;
+            case STRPARM:
+                saved[i].strValue = *(char**)parse_control[i].data;
+                break;
+            default:
+                break;
             }
         }
-    //--- Close file ---
-    status = close( fileHandle );
-    if ( status < 0 )
-        {
-        printf ( "\nFile close error: %s ( %s )\n", filePath, strerror(errno) );
-        return 3;
-        }
-    //--- Release memory ---
-    free( diskData );
+    }
 
-    //--- WRITE PHASE: Open file ---
-    fileHandle = open ( filePath, openFlags );    // open file
-    if ( fileHandle <= 0 )
-        {
-        printf ( "\nFile open error: %s ( %s )\n", filePath, strerror(errno) );
-        return 3;
-        }
-    //--- WRITE PHASE: Map file to virtual address space ---
-    mapLength = fileSize;
-    mapPointer = mmap( mapInput, mapLength, mapProtect, mapFlags,  // map file 
-                    fileHandle, mapOffset );
-    if ( mapPointer == MAP_FAILED )
-        {
-        printf ( "\nFile mapping error: %s ( %s )\n", filePath, strerror(errno) );
-        return 3;
-        }
-    //--- WRITE PHASE: Write delay ---
-    status = usleep( writeDelay * 1000 );
-    if ( status != 0 )
-        {
-        printf( "\nDelay error\n" );
-        return 3;
-        }
-    //--- WRITE PHASE: Time measurement start point ---
-    status = clock_gettime( CLOCK_REALTIME, &ts1 );
-    if( status != 0 )
-        {
-        printf( "\nDelay error ( %s )\n", strerror(errno) );
-        return 3;
-        }
-    //--- WRITE PHASE: Buffer page walk ---
-    char* walkPointer = mapPointer;
-    size_t walkStep = PAGE_WALK_STEP;
-    size_t walkLength = 0;
-    setData = '1';
-    while ( walkLength < mapLength )
+//--- Helper method for restore options variables saved by saveOptions() ---
+// INPUT:   parse_control = options list, null-terminated
+//          saved = array of values
+//---
+void restoreOptions( OPTION_ENTRY parse_control[], OPTION_VALUE saved[] )
+    {
+    int i = 0;
+    for ( i=0; ( parse_control[i].name!=NULL )&&( i<PLAN_OPTIONS ); i++ )
         {
-        *walkPointer = setData;
-        walkPointer += walkStep;
-        walkLength += walkStep;
-        }
-    //--- WRITE PHASE: Flush memory to file ---
-    if ( wsyncMode == 1 )
-	{
-        status = fsync( fileHandle );
-        if ( status < 0 )
+        switch( parse_control[i].routine )
             {
-            printf ( "\nFile flush error: %s ( %s )\n", filePath, strerror(errno) );
-            return 3;
+            case INTPARM:
+            case SELPARM:
+                *(int*)parse_control[i].data = saved[i].intValue;
+                break;
+            case MEMPARM:
+                *(size_t*)parse_control[i].data = saved[i].memValue;
+                break;
+            case OFFPARM:
+                *(off_t*)parse_control[i].data = saved[i].offValue;
+                break;
+            case STRPARM:
+                *(char**)parse_control[i].data = saved[i].strValue;
+                break;
+            default:
+                break;
             }
-         }
-    //--- WRITE PHASE: Time measurement stop point ---
-    status = clock_gettime( CLOCK_REALTIME, &ts2 );
-    if( status != 0 )
-        {
-        printf( "\nGet time error ( %s )\n", strerror(errno) );
-        return 3;
-        }
-    //--- WRITE PHASE: Calculate resut megabytes per second ---
-    sec = ts2.tv_sec  - ts1.tv_sec;
-    ns  = ts2.tv_nsec - ts1.tv_nsec;
-    seconds = ns;
-    seconds *= TIME_TO_SECONDS;       // convert from nanoseconds to seconds
-    seconds += sec;
-    megabytes = fileSize;
-    megabytes /= 1048576.0;           // convert from bytes to megabytes
-    mbps = megabytes / seconds;
-    writeLog[rep] = mbps;
-    handlerProgress( "write", rep, writeLog );
-    //--- WRITE PHASE: Unmap file ---
-    status = munmap( mapPointer, mapLength );
-    if ( status < 0 )
-        {
-        printf ( "\nFile un-mapping error: %s ( %s )\n", filePath, strerror(errno) );
-        return 1;
-        }
-    //--- WRITE PHASE: Close file ---
-    status = close( fileHandle );
-    if ( status < 0 )
-        {
-        printf ( "\nFile close error: %s ( %s )\n", filePath, strerror(errno) );
-        return 3;
-        }
-
-    //--- WRITE PHASE: Delete file ---
-    status = remove( filePath );
-    if ( status < 0 )
-        {
-        printf ( "\nFile delete error: %s ( %s )\n", filePath, strerror(errno) );
-        return 3;
         }
-     }
-
-//--- Cycle for READ ---------------------------------------------------
+    }
 
-printf( "\n" );
-for ( rep=0; rep<repeats; rep++ )
+//--- Helper method for load test plan file ---
+// Options separated by spaces or lines, # starts comment up to end of line,
+// scenario=<name> starts scenario, options before first scenario used by all scenarios.
+// INPUT:   planPath
+// OUTPUT:  status, 0=loaded OK, 1=bad plan, messages output to console
+//          update planTokens[], planTokenCount, planCommonCount, planNames[], planFirst[], planCount[],
+//          planScenarios
+//---
+int loadPlan()
     {
-    //--- Start create temporary file, allocate memory ---
-    bufSize = BUFFER_SIZE;
-    diskData = memalign ( bufAlign, bufSize );
-    if ( diskData<=0 )
-        {
-        printf( "%s ( %s )\n", "Memory allocation failed", strerror(errno) );
-        return 3;
-        }
-    //--- Fill memory ---
-    setData = '0';
-    memset ( diskData, setData, bufSize );
-    //--- Create file ---
-    fileHandle = open ( filePath, createFlags );    // open (create) file
-    if ( fileHandle <= 0 )
+    char line[PLAN_LINE];
+    char* token = NULL;
+    char* comment = NULL;
+    FILE* planFile = NULL;
+    int lineNumber = 0;
+    planFile = fopen( planPath, "r" );
+    if ( planFile == NULL )
         {
-        printf ( "\nFile create error: %s ( %s )\n", filePath, strerror(errno) );
-        return 3;
+        printf( "ERROR, PLAN NOT OPENED: %s ( %s )\n", planPath, strerror(errno) );
+        return 1;
         }
-    //--- Write file from buffer ---
-    ssize_t addSize = 0;
-    ssize_t outSize = 0;
-    ssize_t count = bufSize;
-    while ( addSize < fileSize )
+    planTokenCount = 0;
+    planCommonCount = 0;
+    planScenarios = 0;
+    while ( fgets( line, PLAN_LINE, planFile ) != NULL )
         {
-        if ( ( fileSize - addSize ) < bufSize )
-            {
-            count = fileSize - addSize;
-            }
-        outSize = write( fileHandle, diskData, count );
-        if ( outSize > 0 )
-            {
-            addSize += outSize;
-            }
-        else if ( outSize == 0 )
+        lineNumber++;
+        if ( ( strchr( line, '\n' ) == NULL )&&( !feof( planFile ) ) )
             {
-            printf( "\nUnexpected zero size write error: %s", filePath );
-            return 3;
+            printf( "ERROR, PLAN LINE %d TOO LONG: %s\n", lineNumber, planPath );
+            fclose( planFile );
+            return 1;
             }
-        else
+        comment = strchr( line, '#' );
+        if ( comment != NULL ) { *comment = 0; }
+        for ( token=strtok( line, " \t\r\n" ); token!=NULL; token=strtok( NULL, " \t\r\n" ) )
             {
-            printf ( "\nFile write error: %s ( %s )\n", filePath, strerror(errno) );
-            return 3;
+            if ( ( strchr( token, '=' ) == NULL )||( token[0] == '=' )||( token[strlen(token)-1] == '=' ) )
+                {
+                printf( "ERROR, PLAN LINE %d OPTION INVALID: %s\n", lineNumber, token );
+                fclose( planFile );
+                return 1;
+                }
+            if ( ( strncmp( token, "plan=", 5 ) == 0 )||( strncmp( token, "output=", 7 ) == 0 ) )
+                {
+                printf( "ERROR, PLAN LINE %d OPTION NOT ALLOWED IN PLAN: %s\n", lineNumber, token );
+                fclose( planFile );
+                return 1;
+                }
+            if ( strncmp( token, "scenario=", 9 ) == 0 )
+                {
+                if ( planScenarios >= PLAN_SCENARIOS )
+                    {
+                    printf( "ERROR, PLAN TOO MANY SCENARIOS: maximum %d\n", PLAN_SCENARIOS );
+                    fclose( planFile );
+                    return 1;
+                    }
+                planNames[planScenarios] = strdup( token + 9 );
+                planFirst[planScenarios] = planTokenCount;
+                planCount[planScenarios] = 0;
+                planScenarios++;
+                continue;
+                }
+            if ( planTokenCount >= PLAN_TOKENS )
+                {
+                printf( "ERROR, PLAN TOO MANY OPTIONS: maximum %d\n", PLAN_TOKENS );
+                fclose( planFile );
+                return 1;
+                }
+            planTokens[planTokenCount] = strdup( token );
+            planTokenCount++;
+            if ( planScenarios == 0 ) { planCommonCount++; }
+            else { planCount[planScenarios-1]++; }
             }
         }
-    //--- Close file ---
-    status = close( fileHandle );
-    if ( status < 0 )
+    fclose( planFile );
+    if ( planScenarios == 0 )
         {
-        printf ( "\nFile close error: %s ( %s )\n", filePath, strerror(errno) );
-        return 3;
+        planNames[0] = "default";
+        planFirst[0] = planTokenCount;
+        planCount[0] = 0;
+        planScenarios = 1;
         }
-    //--- Release memory ---
-    free( diskData );
+    return 0;
+    }
 
-    //--- READ PHASE: Open file ---
-    fileHandle = open ( filePath, openFlags );    // open file
-    if ( fileHandle <= 0 )
-        {
-        printf ( "\nFile open error: %s ( %s )\n", filePath, strerror(errno) );
-        return 3;
-        }
-    //--- READ PHASE: Map file to virtual address space ---
-    mapLength = fileSize;
-    mapPointer = mmap( mapInput, mapLength, mapProtect, mapFlags,  // map file 
-                    fileHandle, mapOffset );
-    if ( mapPointer == MAP_FAILED )
-        {
-        printf ( "\nFile mapping error: %s ( %s )\n", filePath, strerror(errno) );
-        return 3;
-        }
-    //--- READ PHASE: Read delay ---
-    status = usleep( readDelay * 1000 );
-    if ( status != 0 )
-        {
-        printf( "\nDelay error ( %s )\n", strerror(errno) );
-        return 3;
-        }
-    //--- READ PHASE: Time measurement start point ---
-    status = clock_gettime( CLOCK_REALTIME, &ts1 );
-    if( status != 0 )
+//--- Helper method for number of runs of scenario, product of values lists lengths ---
+// INPUT:   scenario = scenario index
+// OUTPUT:  number of runs, cartesian product of comma separated values of common and scenario options
+//---
+int planRuns( int scenario )
+    {
+    int runs = 1;
+    int i = 0, j = 0, values = 0;
+    char* token = NULL;
+    for ( i=0; i<( planCommonCount + planCount[scenario] ); i++ )
         {
-        printf( "\nGet time error ( %s )\n", strerror(errno) );
-        return 3;
+        token = i < planCommonCount ? planTokens[i] : planTokens[planFirst[scenario] + i - planCommonCount];
+        values = 1;
+        for ( j=0; token[j]!=0; j++ ) { if ( token[j] == ',' ) values++; }
+        if ( runs > PLAN_RUNS ) return runs;
+        runs *= values;
         }
-    //--- READ PHASE: Buffer page walk ---
-    char* walkPointer = mapPointer;
-    size_t walkStep = PAGE_WALK_STEP;
-    size_t walkLength = 0;
-    setData = 0;
-    while ( walkLength < mapLength )
+    return runs;
+    }
+
+//--- Helper method for build options of one scenario run ---
+// Run number decoded as mixed radix number, digit is value index of option with values list,
+// first option changes slowest, common options applied before scenario options.
+// INPUT:   scenario = scenario index
+//          run = run number of scenario, from 0 to planRuns()-1
+//          args = array for arguments, same as command line, args[0] is application name
+//          texts = array of option strings, storage for arguments
+//          options = string for options list, for visual
+// OUTPUT:  number of arguments, include args[0]
+//---
+int planArguments( int scenario, int run, char* args[], char texts[][PLAN_ARG], char* options )
+    {
+    int count = planCommonCount + planCount[scenario];
+    int i = 0, j = 0, values = 0, index = 0, length = 0;
+    char* token = NULL;
+    char* value = NULL;
+    options[0] = 0;
+    args[0] = planPath;
+    for ( i=count-1; i>=0; i-- )
         {
-        setData = *walkPointer;
-        walkPointer += walkStep;
-        walkLength += walkStep;
+        token = i < planCommonCount ? planTokens[i] : planTokens[planFirst[scenario] + i - planCommonCount];
+        values = 1;
+        for ( j=0; token[j]!=0; j++ ) { if ( token[j] == ',' ) values++; }
+        index = run % values;
+        run /= values;
+        value = strchr( token, '=' ) + 1;
+        for ( j=0; j<index; j++ ) { value = strchr( value, ',' ) + 1; }
+        length = strcspn( value, "," );
+        snprintf( texts[i], PLAN_ARG, "%.*s%.*s", (int)( strchr( token, '=' ) - token + 1 ), token, length, value );
+        args[i+1] = texts[i];
         }
-    //--- READ PHASE: Time measurement stop point ---
-    status = clock_gettime( CLOCK_REALTIME, &ts2 );
-    if( status != 0 )
+    for ( i=0; i<count; i++ )
         {
-        printf( "\nGet time error ( %s )\n", strerror(errno) );
-        return 3;
+        if ( ( strlen( options ) + strlen( texts[i] ) + 2 ) >= PLAN_LINE ) break;
+        if ( i > 0 ) { strcat( options, " " ); }
+        strcat( options, texts[i] );
         }
-    //--- READ PHASE: Calculate resut megabytes per second ---
-    sec = ts2.tv_sec  - ts1.tv_sec;
-    ns  = ts2.tv_nsec - ts1.tv_nsec;
-    seconds = ns;
-    seconds *= TIME_TO_SECONDS;       // convert from nanoseconds to seconds
-    seconds += sec;
-    megabytes = fileSize;
-    megabytes /= 1048576.0;           // convert from bytes to megabytes
-    mbps = megabytes / seconds;
-    readLog[rep] = mbps;
-    handlerProgress( "read", rep, readLog );
-    //--- READ PHASE: Unmap file ---
-    status = munmap( mapPointer, mapLength );
-    if ( status < 0 )
+    return count + 1;
+    }
+
+//--- Run test plan: all scenarios runs back to back without prompt, summary table ---
+// Options of all runs checked before first run, command line options restored before each run,
+// run with bad parameters skipped, run error stops plan.
+// INPUT:   planPath, command line options variables used as defaults
+// OUTPUT:  status, 0=plan done, otherwise error, messages output to console
+//          update planRun arrays, planInvalid
+//---
+int runPlan()
+{
+OPTION_VALUE defaults[PLAN_OPTIONS];
+char* args[PLAN_TOKENS + 1];
+char texts[PLAN_TOKENS][PLAN_ARG];
+char options[PLAN_LINE];
+char name[PLAN_ARG];
+int i = 0, run = 0, runs = 0, total = 0, count = 0;
+
+//--- Load plan file, check options of all runs ---
+if ( loadPlan() != 0 ) return 1;
+saveOptions( ipb_list, defaults );
+for ( i=0; i<planScenarios; i++ )
+    {
+    runs = planRuns( i );
+    total += runs;
+    if ( total > PLAN_RUNS )
         {
-        printf ( "\nFile un-mapping error: %s ( %s )\n", filePath, strerror(errno) );
+        printf( "ERROR, PLAN TOO MANY RUNS: maximum %d\n", PLAN_RUNS );
         return 1;
         }
-    //--- READ PHASE: Close file ---
-    status = close( fileHandle );
-    if ( status < 0 )
+    for ( run=0; run<runs; run++ )
         {
-        printf ( "\nFile close error: %s ( %s )\n", filePath, strerror(errno) );
-        return 3;
+        count = planArguments( i, run, args, texts, options );
+        if ( handlerInput( count, args, ipb_list ) != 0 )
+            {
+            printf( "ERROR, PLAN SCENARIO %s: %s\n", planNames[i], options );
+            return 1;
+            }
+        restoreOptions( ipb_list, defaults );
         }
+    }
+printf( "Test plan %s: %d scenarios, %d runs.\n", planPath, planScenarios, total );
 
-    //--- READ PHASE: Delete file ---
-    status = remove( filePath );
-    if ( status < 0 )
+//--- Run scenarios, defaults restored before each run ---
+scenarioIndex = 0;
+for ( i=0; i<planScenarios; i++ )
+    {
+    runs = planRuns( i );
+    for ( run=0; run<runs; run++ )
         {
-        printf ( "\nFile delete error: %s ( %s )\n", filePath, strerror(errno) );
-        return 3;
+        restoreOptions( ipb_list, defaults );
+        count = planArguments( i, run, args, texts, options );
+        handlerInput( count, args, ipb_list );
+        if ( runs > 1 ) { snprintf( name, PLAN_ARG, "%s.%d", planNames[i], run + 1 ); }
+        else { snprintf( name, PLAN_ARG, "%s", planNames[i] ); }
+        planRunNames[scenarioIndex] = strdup( name );
+        planRunOptions[scenarioIndex] = strdup( options );
+        planRunWrite[scenarioIndex] = -1.0;
+        planRunRead[scenarioIndex] = -1.0;
+        scenarioName = planRunNames[scenarioIndex];
+        scenarioIndex++;
+        benchmarkIndex = 0;
+        printf( "\n\nScenario %d of %d: %s ( %s )\n\n", scenarioIndex, total, name, options );
+        outputRecord( "scenario", NULL, 0, "name", name, 1 );
+        outputRecord( "scenario", NULL, 0, "options", options, 1 );
+        status = checkConfiguration();
+        planRunStatus[scenarioIndex-1] = status;
+        if ( status != 0 )
+            {
+            printf( "Scenario skipped.\n" );
+            perfCloseGroup( perfHandles );
+            planInvalid++;
+            continue;
+            }
+        writeMedian = -1.0;
+        readMedian = -1.0;
+        status = runConfiguration();
+        perfCloseGroup( perfHandles );
+        if ( status != 0 ) return status;
+        if ( ( sweepMode == SWEEP_NONE )&&( adviceMode != ADVICE_ALL ) )
+            {
+            planRunWrite[scenarioIndex-1] = writeMedian;
+            planRunRead[scenarioIndex-1] = readMedian;
+            }
         }
     }
+restoreOptions( ipb_list, defaults );
+scenarioName = "none";
 
-printf( "\n-------------------------------------------------------------------------\n" );
+//--- Consolidated results table ---
+printf( "\nTest plan summary (median MBPS):\n" );
+printf( "Scenario             | Write      | Read       | Options\n" );
+printf( "-------------------------------------------------------------------------------\n" );
+for ( i=0; i<scenarioIndex; i++ )
+    {
+    printf( " %-20s", planRunNames[i] );
+    if ( planRunStatus[i] != 0 ) { printf( "%11s%13s", "skipped", "skipped" ); }
+    else if ( planRunWrite[i] < 0.0 ) { printf( "%11s%13s", "see above", "see above" ); }
+    else { printf( "%11.3f%13.3f", planRunWrite[i], planRunRead[i] ); }
+    printf( "   %s\n", planRunOptions[i] );
+    }
+printf( "-------------------------------------------------------------------------------\n" );
+printf( "Skipped = bad parameters, see above = sweep or advice=all results table.\n" );
+return 0;
+}
 
+//---------- Application entry point -------------------------------------------
 
-//--- Print summary info -----------------------------------------------
+int main( int argc, char** argv )
+{
 
-//--- Print output parameters, read results ---
-printf( "\nWrite statistics (MBPS):\n" );
-calculateStatistics(  writeLog, repeats,
-                     &resultMedian, &resultAverage,
-                     &resultMinimum, &resultMaximum );
-handlerOutput( opb_list, OPB_TABS );
+//--- Parse command line, open machine readable output if selected ---
+if ( handlerInput( argc, argv, ipb_list ) != 0 ) return 1;
+if ( outputOpen() != 0 ) return 3;
 
-//--- Print output parameters, read results ---
-printf( "\nRead statistics (MBPS):\n" );
-calculateStatistics(  readLog, repeats,
-                     &resultMedian, &resultAverage,
-                     &resultMinimum, &resultMaximum );
-handlerOutput( opb_list, OPB_TABS );
+//--- Start message ---
+printf( "\n%s\n\n", TITLE );
+
+//--- Test plan: scenarios run back to back without prompt ---
+if ( planPath[0] != 0 )
+    {
+    status = runPlan();
+    if ( status != 0 ) return status;
+    }
+else
+    {
+    //--- Check start conditions ---
+    status = checkConfiguration();
+    if ( status != 0 ) return status;
+
+    //--- Wait for key (Y/N) with list of start parameters ---
+    printf("\nStart? (Y/N)" );
+    int key = 0;
+    key = getchar();
+    key = tolower(key);
+    if ( key != 'y' )
+        {
+        printf( "Test skipped.\n" );
+        return 3;
+        }
+
+    //--- Run benchmark, single advice, all advices cycle or sweep ---
+    status = runConfiguration();
+    if ( status != 0 ) return status;
+    }
 
 //--- Print application statistics by OS info ---
 printf ( "\nLinux system resources usage statistics:\n" );
 printResourceStatistics();
+perfCloseGroup( perfHandles );
     
-//--- Exit ---
+//--- Exit, test plan with skipped scenarios returns bad parameter status ---
 printf( "\nDone.\n" );
-return 0;
+return planInvalid != 0 ? 1 : 0;
 
 }
 